@@ -144,6 +144,15 @@ extern "C" {
  #include <stddef.h>
 #endif
 
+/* The keyboard state API uses 64-bit words, but Visual C++ only has
+ * <stdint.h> from version 2010 */
+#if defined(_MSC_VER) && (_MSC_VER < 1600)
+ typedef unsigned __int64 GLFWuint64;
+#else
+ #include <stdint.h>
+ typedef uint64_t GLFWuint64;
+#endif
+
 
 /* ---------------- GLFW related system specific defines ----------------- */
 
@@ -388,6 +397,9 @@ extern "C" {
 #define GLFW_KEY_MENU               348
 #define GLFW_KEY_LAST               GLFW_KEY_MENU
 
+/* The number of 64-bit words in a keyboard state bitset */
+#define GLFW_KEY_STATE_WORDS        ((GLFW_KEY_LAST + 64) / 64)
+
 /* GLFW 2.x key name aliases (deprecated) */
 #define GLFW_KEY_ESC                GLFW_KEY_ESCAPE
 #define GLFW_KEY_DEL                GLFW_KEY_DELETE
@@ -489,8 +501,10 @@ extern "C" {
 #define GLFW_VISIBLE                0x00022008
 #define GLFW_POSITION_X             0x00022009
 #define GLFW_POSITION_Y             0x0002200A
+#define GLFW_REFRESH_RATE           0x0002200B
 
 #define GLFW_CONTEXT_REVISION       0x00020004
+#define GLFW_REPLAYING              0x00020005
 #define GLFW_RED_BITS               0x00021000
 #define GLFW_GREEN_BITS             0x00021001
 #define GLFW_BLUE_BITS              0x00021002
@@ -528,6 +542,7 @@ extern "C" {
 #define GLFW_CURSOR_MODE            0x00030001
 #define GLFW_STICKY_KEYS            0x00030002
 #define GLFW_STICKY_MOUSE_BUTTONS   0x00030003
+#define GLFW_EVENT_COMPRESSION      0x00030004
 
 #define GLFW_CURSOR_NORMAL          0x00040001
 #define GLFW_CURSOR_HIDDEN          0x00040002
@@ -537,6 +552,12 @@ extern "C" {
 #define GLFW_AXES                   0x00050002
 #define GLFW_BUTTONS                0x00050003
 
+#define GLFW_JOYSTICK_POLLING       0x00051001
+
+#define GLFW_POLL_ON_EVENTS         0x00052001
+#define GLFW_POLL_ON_QUERY          0x00052002
+#define GLFW_POLL_ON_THREAD         0x00052003
+
 #define GLFW_GAMMA_RAMP_SIZE        256
 
 #define GLFW_MONITOR_WIDTH_MM       0x00060001
@@ -547,6 +568,21 @@ extern "C" {
 #define GLFW_CONNECTED              0x00061000
 #define GLFW_DISCONNECTED           0x00061001
 
+#define GLFW_WINDOW_POS_EVENT       0x00080001
+#define GLFW_WINDOW_SIZE_EVENT      0x00080002
+#define GLFW_WINDOW_CLOSE_EVENT     0x00080003
+#define GLFW_WINDOW_REFRESH_EVENT   0x00080004
+#define GLFW_WINDOW_FOCUS_EVENT     0x00080005
+#define GLFW_WINDOW_ICONIFY_EVENT   0x00080006
+#define GLFW_KEY_EVENT              0x00080007
+#define GLFW_CHAR_EVENT             0x00080008
+#define GLFW_MOUSE_BUTTON_EVENT     0x00080009
+#define GLFW_CURSOR_POS_EVENT       0x0008000A
+#define GLFW_CURSOR_ENTER_EVENT     0x0008000B
+#define GLFW_SCROLL_EVENT           0x0008000C
+#define GLFW_JOYSTICK_AXIS_EVENT    0x0008000D
+#define GLFW_JOYSTICK_BUTTON_EVENT  0x0008000E
+
 
 /*************************************************************************
  * GLFW API types
@@ -677,6 +713,29 @@ typedef void (* GLFWcharfun)(GLFWwindow*,int);
  */
 typedef void (* GLFWmonitorfun)(GLFWmonitor*,int);
 
+/*! @brief The function signature for joystick configuration callbacks.
+ *  @param[in] joy The joystick that was connected or disconnected.
+ *  @param[in] event One of @ref GLFW_CONNECTED or @ref GLFW_DISCONNECTED.
+ *  @ingroup input
+ */
+typedef void (* GLFWjoystickfun)(int,int);
+
+/*! @brief The function signature for joystick axis callbacks.
+ *  @param[in] joy The joystick whose axis moved.
+ *  @param[in] axis The axis that moved.
+ *  @param[in] value The new position of the axis, in the range -1.0 to 1.0.
+ *  @ingroup input
+ */
+typedef void (* GLFWjoystickaxisfun)(int,int,float);
+
+/*! @brief The function signature for joystick button callbacks.
+ *  @param[in] joy The joystick whose button changed.
+ *  @param[in] button The button that was pressed or released.
+ *  @param[in] action One of @ref GLFW_PRESS or @ref GLFW_RELEASE.
+ *  @ingroup input
+ */
+typedef void (* GLFWjoystickbuttonfun)(int,int,int);
+
 /* @brief Video mode type.
  * @ingroup monitor
  */
@@ -687,6 +746,7 @@ typedef struct
     int redBits;
     int blueBits;
     int greenBits;
+    int refreshRate;
 } GLFWvidmode;
 
 /*! @brief Gamma ramp.
@@ -699,6 +759,60 @@ typedef struct
     unsigned short blue[GLFW_GAMMA_RAMP_SIZE];
 } GLFWgammaramp;
 
+/*! @brief Queued event record.
+ *  @ingroup window
+ *
+ *  The members of @c data that are valid depend on the event type, and match
+ *  the parameters of the corresponding callback.  Focus, iconify and cursor
+ *  enter events use @c state.
+ */
+typedef struct
+{
+    /*! The type of the event, for example @ref GLFW_KEY_EVENT. */
+    int type;
+    /*! The window that received the event. */
+    GLFWwindow* window;
+    /*! The time at which the event occurred, as returned by @ref
+     *  glfwGetEventTime. */
+    double time;
+    /*! The event parameters. */
+    union
+    {
+        struct { int x, y; } pos;
+        struct { int width, height; } size;
+        struct { int key, action; } key;
+        struct { int button, action; } button;
+        struct { double x, y; } scroll;
+        int character;
+        int state;
+    } data;
+} GLFWevent;
+
+/*! @brief Joystick history record.
+ *  @ingroup input
+ *
+ *  Axis events use @c value, which is the new position of the axis.  Button
+ *  events use @c action, which is either @ref GLFW_PRESS or @ref
+ *  GLFW_RELEASE.
+ */
+typedef struct
+{
+    /*! The type of the event, either @ref GLFW_JOYSTICK_AXIS_EVENT or @ref
+     *  GLFW_JOYSTICK_BUTTON_EVENT. */
+    int type;
+    /*! The axis or button that changed. */
+    int index;
+    /*! The time at which the change occurred, on the same timebase as @ref
+     *  glfwGetTime. */
+    double time;
+    /*! The new state of the axis or button. */
+    union
+    {
+        float value;
+        int action;
+    } data;
+} GLFWjoystickevent;
+
 
 /*************************************************************************
  * GLFW API functions
@@ -799,6 +913,9 @@ GLFWAPI void glfwSetErrorCallback(GLFWerrorfun cbfun);
  *  @param[out] count The size of the returned array.
  *  @return An array of monitor handles.
  *  @ingroup monitor
+ *
+ *  @note The returned array is only valid until a monitor is connected or
+ *  disconnected.  The handles of monitors that remain connected stay valid.
  */
 GLFWAPI GLFWmonitor** glfwGetMonitors(int* count);
 
@@ -831,6 +948,10 @@ GLFWAPI void glfwSetMonitorCallback(GLFWmonitorfun cbfun);
  *  @param[out] count The number of video modes in the returned array.
  *  @return An array of video modes.
  *  @ingroup monitor
+ *
+ *  @note The modes are retrieved once and then cached, so repeated calls
+ *  return the same array.  It remains valid until the monitor configuration
+ *  changes, the monitor is disconnected or the library is terminated.
  */
 GLFWAPI const GLFWvidmode* glfwGetVideoModes(GLFWmonitor* monitor, int* count);
 
@@ -838,6 +959,12 @@ GLFWAPI const GLFWvidmode* glfwGetVideoModes(GLFWmonitor* monitor, int* count);
  *  @param[in] monitor The monitor to query.
  *  @return The current mode of the monitor.
  *  @ingroup monitor
+ *
+ *  @note The refresh rate is in Hz, rounded to the nearest integer, and is
+ *  zero if the system does not report it.
+ *
+ *  @note The width, height and refresh rate are zero if the monitor is
+ *  connected but currently disabled.
  */
 GLFWAPI GLFWvidmode glfwGetVideoMode(GLFWmonitor* monitor);
 
@@ -990,6 +1117,11 @@ GLFWAPI void glfwDefaultWindowHints(void);
  *  The @ref GLFW_POSITION_X and @ref GLFW_POSITION_Y hints specify the initial
  *  position of the window.  These hints are ignored for fullscreen windows.
  *
+ *  The @ref GLFW_REFRESH_RATE hint specifies the desired refresh rate, in Hz,
+ *  of the video mode of fullscreen windows.  Zero means the highest rate
+ *  available at the chosen resolution.  This hint is ignored for windowed
+ *  mode windows.
+ *
  *  @note This function may only be called from the main thread.
  *
  *  @sa glfwDefaultWindowHints
@@ -1306,15 +1438,101 @@ GLFWAPI void glfwPollEvents(void);
  *  @note This function may only be called from the main thread.
  *
  *  @sa glfwPollEvents
+ *  @sa glfwWaitEventsTimeout
  */
 GLFWAPI void glfwWaitEvents(void);
 
+/*! @brief Waits with timeout until events are pending and processes them.
+ *  @param[in] timeout The maximum amount of time, in seconds, to wait.
+ *  @ingroup window
+ *
+ *  This function puts the calling thread to sleep until at least one event
+ *  has been received or the specified timeout has elapsed, and then
+ *  processes all received events.  Events that have already been received
+ *  but not yet processed cause it to return immediately.
+ *
+ *  @note This function may only be called from the main thread.
+ *
+ *  @sa glfwPollEvents
+ *  @sa glfwWaitEvents
+ */
+GLFWAPI void glfwWaitEventsTimeout(double timeout);
+
+/*! @brief Posts an empty event to the event queue.
+ *  @ingroup window
+ *
+ *  This function posts an empty event to the event queue, causing @ref
+ *  glfwWaitEvents or @ref glfwWaitEventsTimeout to return.  No callbacks are
+ *  called for the empty event.
+ *
+ *  @remarks This function may be called from secondary threads.
+ *
+ *  @sa glfwWaitEvents
+ *  @sa glfwWaitEventsTimeout
+ */
+GLFWAPI void glfwPostEmptyEvent(void);
+
+/*! @brief Returns the time of the event being processed.
+ *  @return The time at which the event occurred, in seconds.
+ *  @ingroup window
+ *
+ *  This function returns the time at which the event currently being
+ *  reported to a callback occurred, or the time of the most recently
+ *  processed event if called outside of a callback.  The time is on the same
+ *  timebase as @ref glfwGetTime.
+ *
+ *  If the window system provides a timestamp for the event, that timestamp
+ *  is mapped onto the GLFW timer, with the offset between the two clocks
+ *  continuously recalibrated to follow any drift between them.  Otherwise,
+ *  the time at which the event was processed is returned.
+ *
+ *  @note Key, mouse button, cursor motion and cursor enter events have
+ *  timestamps on all platforms.
+ *
+ *  @sa glfwGetTime
+ */
+GLFWAPI double glfwGetEventTime(void);
+
+/*! @brief Sets the size of the event queue.
+ *  @param[in] size The maximum number of queued events, or zero to disable
+ *  the event queue.
+ *  @ingroup window
+ *
+ *  This function enables or disables the event queue.  While the event queue
+ *  is enabled, window and input events are stored in it instead of being
+ *  passed to callbacks, and are retrieved with @ref glfwGetEvents.  Any events
+ *  already in the queue are discarded.
+ *
+ *  The queue is allocated by this function and never grows.  Events received
+ *  while it is full are dropped, and a @ref GLFW_OUT_OF_MEMORY error is
+ *  reported by the next call to @ref glfwGetEvents.
+ *
+ *  @note The event queue is disabled by default.
+ *
+ *  @sa glfwGetEvents
+ */
+GLFWAPI void glfwSetEventQueueSize(int size);
+
+/*! @brief Retrieves and removes events from the event queue.
+ *  @param[out] events The array to store the events in.
+ *  @param[in] count The size of the array.
+ *  @return The number of events stored in the array.
+ *  @ingroup window
+ *
+ *  This function moves up to @c count of the oldest events in the event
+ *  queue into the specified array, in the order they were received.
+ *
+ *  @sa glfwSetEventQueueSize
+ */
+GLFWAPI int glfwGetEvents(GLFWevent* events, int count);
+
 /*! @brief Returns the value of an input option for the specified window.
  *  @param[in] window The window to query.
  *  @param[in] mode One of the following:
  *  @arg @ref GLFW_CURSOR_MODE Sets the cursor mode.
  *  @arg @ref GLFW_STICKY_KEYS Sets whether sticky keys are enabled.
  *  @arg @ref GLFW_STICKY_MOUSE_BUTTONS Sets whether sticky mouse buttons are enabled.
+ *  @arg @ref GLFW_EVENT_COMPRESSION Sets whether event compression is enabled.
  *  @ingroup input
  *
  *  @sa glfwSetInputMode
@@ -1323,15 +1541,70 @@ GLFWAPI int glfwGetInputMode(GLFWwindow* window, int mode);
 
 /*! @brief Sets an input option for the specified window.
  *  @param[in] window The window whose input mode to set.
- *  @param[in] mode One of @ref GLFW_CURSOR_MODE, @ref GLFW_STICKY_KEYS or @ref
- *  GLFW_STICKY_MOUSE_BUTTONS.
+ *  @param[in] mode One of @ref GLFW_CURSOR_MODE, @ref GLFW_STICKY_KEYS, @ref
+ *  GLFW_STICKY_MOUSE_BUTTONS or @ref GLFW_EVENT_COMPRESSION.
  *  @param[in] value The new value of the specified input mode.
  *  @ingroup input
  *
+ *  @remarks When event compression is enabled, consecutive cursor motion,
+ *  window size and position and window damage events received for the
+ *  window in a single event processing pass are each folded into the last
+ *  one, so callbacks are only called with the final state.  Window damage is
+ *  also only reported once the last rectangle of each exposed region has
+ *  arrived.
+ *
+ *  @note Event compression currently only has an effect on X11.
+ *
  *  @sa glfwGetInputMode
  */
 GLFWAPI void glfwSetInputMode(GLFWwindow* window, int mode, int value);
 
+/*! @brief Starts or stops recording the input of the specified window.
+ *  @param[in] window The window whose input to record.
+ *  @param[in] path The path of the file to record to, or @c NULL to stop
+ *  recording.
+ *  @return @c GL_TRUE if successful, or @c GL_FALSE if an error occurred.
+ *  @ingroup input
+ *
+ *  This function records every window and input event received by the
+ *  specified window, along with its time relative to the start of the
+ *  recording, to a binary file.  Any previous recording for the window is
+ *  stopped first.
+ *
+ *  @note Recordings are stored in host byte order and are not portable
+ *  between platforms.
+ *
+ *  @sa glfwReplayInput
+ */
+GLFWAPI int glfwRecordInput(GLFWwindow* window, const char* path);
+
+/*! @brief Starts or stops replaying recorded input to the specified window.
+ *  @param[in] window The window to replay the input to.
+ *  @param[in] path The path of the recording to replay, or @c NULL to stop
+ *  replaying.
+ *  @param[in] speed The playback speed relative to the original recording,
+ *  or zero to replay all events as soon as possible.
+ *  @return @c GL_TRUE if successful, or @c GL_FALSE if an error occurred.
+ *  @ingroup input
+ *
+ *  This function loads a recording made with @ref glfwRecordInput and feeds
+ *  its events to the specified window during subsequent calls to @ref
+ *  glfwPollEvents, @ref glfwWaitEvents and @ref glfwWaitEventsTimeout, as if
+ *  they had been received from the window system at the recorded times.
+ *  Events received from the window system for the window are discarded
+ *  while it is replaying.
+ *
+ *  The replay stops once all recorded events have been delivered.  Whether
+ *  a window is replaying can be queried with the @ref GLFW_REPLAYING window
+ *  parameter.
+ *
+ *  @note Replayed window size, position and iconification events only
+ *  update the state reported by GLFW and do not change the actual window.
+ *
+ *  @sa glfwRecordInput
+ */
+GLFWAPI int glfwReplayInput(GLFWwindow* window, const char* path, double speed);
+
 /*! @brief Returns the last reported state of a keyboard key for the specified
  *  window.
  *  @param[in] window The desired window.
@@ -1341,6 +1614,29 @@ GLFWAPI void glfwSetInputMode(GLFWwindow* window, int mode, int value);
  */
 GLFWAPI int glfwGetKey(GLFWwindow* window, int key);
 
+/*! @brief Retrieves the state of all keyboard keys for the specified window.
+ *  @param[in] window The desired window.
+ *  @param[out] pressed Where to store the keys that are pressed, or @c NULL.
+ *  @param[out] pressedSinceLastPoll Where to store the keys that were pressed
+ *  during the last event processing call, or @c NULL.
+ *  @ingroup input
+ *
+ *  This function retrieves the last reported state of all keyboard keys as
+ *  bitsets of @ref GLFW_KEY_STATE_WORDS words each, where the state of key @c
+ *  k is bit <tt>k % 64</tt> of word <tt>k / 64</tt>.  The @c pressed bitset
+ *  matches what @ref glfwGetKey would return for each key, including sticky
+ *  keys, which are released by this call.
+ *
+ *  The @c pressedSinceLastPoll bitset holds the keys that were pressed
+ *  during the most recent call to @ref glfwPollEvents, @ref glfwWaitEvents
+ *  or @ref glfwWaitEventsTimeout, even if they have been released again.
+ *
+ *  @sa glfwGetKey
+ */
+GLFWAPI void glfwGetKeyboardState(GLFWwindow* window,
+                                  GLFWuint64* pressed,
+                                  GLFWuint64* pressedSinceLastPoll);
+
 /*! @brief Returns the last reported state of a mouse button for the specified
  *  window.
  *  @param[in] window The desired window.
@@ -1448,6 +1744,14 @@ GLFWAPI void glfwSetScrollCallback(GLFWwindow* window, GLFWscrollfun cbfun);
  *  @return The specified joystick's current value, or zero if the joystick is
  *  not present.
  *  @ingroup input
+ *
+ *  @note On Linux, if the @c GLFW_JOYSTICK_DIR environment variable is set
+ *  at initialization, joysticks are only looked for in the directory it
+ *  names.  FIFOs there with the names of joystick device nodes are read as
+ *  joysticks with 32 axes and 32 buttons, so that joystick input can be
+ *  tested without hardware.  A joystick is disconnected when the writer of
+ *  its FIFO closes it.  Event device FIFOs are expected to be timestamped
+ *  with @c CLOCK_MONOTONIC.
  */
 GLFWAPI int glfwGetJoystickParam(int joy, int param);
 
@@ -1480,6 +1784,108 @@ GLFWAPI int glfwGetJoystickButtons(int joy, unsigned char* buttons, int numbutto
  */
 GLFWAPI const char* glfwGetJoystickName(int joy);
 
+/*! @brief Retrieves and removes changes from the history of a joystick.
+ *  @param[in] joy The joystick to query.
+ *  @param[out] events The array to store the changes in.
+ *  @param[in] count The size of the array.
+ *  @return The number of changes stored in the array.
+ *  @ingroup input
+ *
+ *  Every axis and button change read from a joystick is recorded with its
+ *  time, oldest first, so that transitions between two frames are not lost.
+ *  The history of each joystick is bounded.  When it is full, the oldest
+ *  changes are discarded and a @ref GLFW_OUT_OF_MEMORY error is reported by
+ *  the next call to this function.  The history is cleared when a joystick
+ *  is connected.
+ *
+ *  @note Joystick history is currently only recorded on Linux.
+ */
+GLFWAPI int glfwGetJoystickEvents(int joy, GLFWjoystickevent* events, int count);
+
+/*! @brief Sets the specified joystick hint to the desired value.
+ *  @param[in] target The joystick hint to set. Currently only @ref
+ *  GLFW_JOYSTICK_POLLING.
+ *  @param[in] hint The new value of the joystick hint.
+ *  @ingroup input
+ *
+ *  @remarks By default (@ref GLFW_POLL_ON_EVENTS), joysticks are read when
+ *  events are processed. The joystick query functions then return the state
+ *  as of the last call to @ref glfwPollEvents, @ref glfwWaitEvents or @ref
+ *  glfwWaitEventsTimeout. With @ref GLFW_POLL_ON_QUERY, every query reads the
+ *  joysticks first, as in earlier versions.
+ *
+ *  @remarks With @ref GLFW_POLL_ON_THREAD, a background thread reads the
+ *  joysticks as soon as they have input.  @ref glfwGetJoystickParam, @ref
+ *  glfwGetJoystickAxes and @ref glfwGetJoystickButtons then return its latest
+ *  consistent snapshot and may be called from any thread, without blocking.
+ *  Connections and disconnections are still reported by event processing.
+ *  Joystick history is not recorded in this mode.
+ *
+ *  @note On Windows, joystick state is always read when it is queried.
+ *
+ *  @note @ref GLFW_POLL_ON_THREAD is currently only supported on Linux.
+ */
+GLFWAPI void glfwJoystickHint(int target, int hint);
+
+/*! @brief Sets the joystick configuration callback.
+ *  @param[in] cbfun The new callback, or @c NULL to remove the currently set.
+ *  @ingroup input
+ *
+ *  @note Joysticks are detected while events are processed and, on some
+ *  platforms, when joystick state is queried.
+ *
+ *  @note Joysticks connected after initialization are currently only
+ *  detected on Linux.
+ */
+GLFWAPI void glfwSetJoystickCallback(GLFWjoystickfun cbfun);
+
+/*! @brief Sets the joystick axis callback.
+ *  @param[in] cbfun The new callback, or @c NULL to remove the currently set.
+ *  @ingroup input
+ *
+ *  The callback is called for every axis change read from a joystick, unless
+ *  it is smaller than the threshold set with @ref glfwSetJoystickAxisThreshold.
+ *
+ *  @note Joystick axes are read while events are processed or, with @ref
+ *  GLFW_POLL_ON_QUERY, when joystick state is queried.  The callback is not
+ *  called with @ref GLFW_POLL_ON_THREAD.
+ *
+ *  @note Joystick axis and button callbacks are currently only called on
+ *  Linux.
+ */
+GLFWAPI void glfwSetJoystickAxisCallback(GLFWjoystickaxisfun cbfun);
+
+/*! @brief Sets the joystick button callback.
+ *  @param[in] cbfun The new callback, or @c NULL to remove the currently set.
+ *  @ingroup input
+ *
+ *  @note Joystick buttons are read while events are processed or, with @ref
+ *  GLFW_POLL_ON_QUERY, when joystick state is queried.  The callback is not
+ *  called with @ref GLFW_POLL_ON_THREAD.
+ *
+ *  @note Joystick axis and button callbacks are currently only called on
+ *  Linux.
+ */
+GLFWAPI void glfwSetJoystickButtonCallback(GLFWjoystickbuttonfun cbfun);
+
+/*! @brief Sets how far a joystick axis must move to be reported.
+ *  @param[in] joy The joystick whose axis to configure.
+ *  @param[in] axis The axis to configure.
+ *  @param[in] threshold The smallest change passed to the axis callback, or
+ *  zero to pass every change.
+ *  @ingroup input
+ *
+ *  Movement is measured from the position last passed to the axis callback,
+ *  so slow drift is still reported once it adds up to the threshold.  The
+ *  center and both ends of the axis are always reported.  The threshold
+ *  does not affect the joystick history or the query functions.
+ *
+ *  The threshold belongs to the joystick slot and is kept when a different
+ *  joystick is connected to it.  Only the first 64 axes of each joystick
+ *  can have a threshold.
+ */
+GLFWAPI void glfwSetJoystickAxisThreshold(int joy, int axis, float threshold);
+
 /*! @brief Sets the clipboard to the specified string.
  *  @param[in] window The window that will own the clipboard contents.
  *  @param[in] string A UTF-8 encoded string.
@@ -282,11 +282,15 @@ static void removalCallback(void* target, IOReturn result, void* refcon, void* s
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+//////                       GLFW internal API                      //////
+//////////////////////////////////////////////////////////////////////////
+
 //========================================================================
 // Polls for joystick events and updates GLFW state
 //========================================================================
 
-static void pollJoystickEvents(void)
+void _glfwPollJoystickEvents(void)
 {
     int i;
     CFIndex j;
@@ -322,10 +326,6 @@ static void pollJoystickEvents(void)
 }
 
 
-//////////////////////////////////////////////////////////////////////////
-//////                       GLFW internal API                      //////
-//////////////////////////////////////////////////////////////////////////
-
 //========================================================================
 // Initialize joystick interface
 //========================================================================
@@ -537,7 +537,8 @@ int _glfwPlatformGetJoystickAxes(int joy, float* axes, int numaxes)
     numaxes = numaxes < joystick.numAxes ? numaxes : joystick.numAxes;
 
     // Update joystick state
-    pollJoystickEvents();
+    if (_glfw.joystickPolling == GLFW_POLL_ON_QUERY)
+        _glfwPollJoystickEvents();
 
     for (i = 0;  i < numaxes;  i++)
     {
@@ -575,7 +576,8 @@ int _glfwPlatformGetJoystickButtons(int joy, unsigned char* buttons,
     }
 
     // Update joystick state
-    pollJoystickEvents();
+    if (_glfw.joystickPolling == GLFW_POLL_ON_QUERY)
+        _glfwPollJoystickEvents();
 
     for (button = 0;  button < numbuttons && button < joystick.numButtons;  button++)
     {
@@ -616,3 +618,15 @@ const char* _glfwPlatformGetJoystickName(int joy)
     return _glfwJoysticks[joy].name;
 }
 
+int _glfwPlatformSetJoystickPolling(int mode)
+{
+    if (mode == GLFW_POLL_ON_THREAD)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Cocoa: Joystick polling on a thread is not supported");
+        return GL_FALSE;
+    }
+
+    return GL_TRUE;
+}
+
@@ -111,6 +111,9 @@ static GLFWvidmode vidmodeFromCGDisplayMode(CGDisplayModeRef mode)
     result.width = CGDisplayModeGetWidth(mode);
     result.height = CGDisplayModeGetHeight(mode);
 
+    // This is zero for most built-in displays
+    result.refreshRate = (int) (CGDisplayModeGetRefreshRate(mode) + 0.5);
+
     CFStringRef format = CGDisplayModeCopyPixelEncoding(mode);
 
     if (CFStringCompare(format, CFSTR(IO16BitDirectPixels), 0) == 0)
@@ -112,6 +112,7 @@ void _glfwInitTimer(void);
 // Joystick input
 void _glfwInitJoysticks(void);
 void _glfwTerminateJoysticks(void);
+void _glfwPollJoystickEvents(void);
 
 // Fullscreen
 GLboolean _glfwSetVideoMode(_GLFWmonitor* monitor, int* width, int* height, int* bpp);
@@ -717,6 +717,23 @@ static GLboolean createWindow(_GLFWwindow* window,
 }
 
 
+//========================================================================
+// Dispatches the specified event along with its timestamp
+//========================================================================
+
+static void sendEvent(NSEvent* event)
+{
+    // Event timestamps are seconds since system startup, but application
+    // defined events, like those posted by glfwPostEmptyEvent, may have none
+    if ([event type] == NSApplicationDefined)
+        _glfwInputEventTime(-1.0);
+    else
+        _glfwInputEventTime([event timestamp]);
+
+    [NSApp sendEvent:event];
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW platform API                      //////
 //////////////////////////////////////////////////////////////////////////
@@ -857,9 +874,11 @@ void _glfwPlatformPollEvents(void)
         if (event == nil)
             break;
 
-        [NSApp sendEvent:event];
+        sendEvent(event);
     }
 
+    _glfwPollJoystickEvents();
+
     [_glfw.ns.autoreleasePool drain];
     _glfw.ns.autoreleasePool = [[NSAutoreleasePool alloc] init];
 }
@@ -873,11 +892,40 @@ void _glfwPlatformWaitEvents(void)
                                         untilDate:[NSDate distantFuture]
                                            inMode:NSDefaultRunLoopMode
                                           dequeue:YES];
-    [NSApp sendEvent:event];
+    sendEvent(event);
+
+    _glfwPlatformPollEvents();
+}
+
+void _glfwPlatformWaitEventsTimeout(double timeout)
+{
+    NSDate* date = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    NSEvent* event = [NSApp nextEventMatchingMask:NSAnyEventMask
+                                        untilDate:date
+                                           inMode:NSDefaultRunLoopMode
+                                          dequeue:YES];
+    if (event)
+        sendEvent(event);
 
     _glfwPlatformPollEvents();
 }
 
+void _glfwPlatformPostEmptyEvent(void)
+{
+    NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+    NSEvent* event = [NSEvent otherEventWithType:NSApplicationDefined
+                                        location:NSMakePoint(0, 0)
+                                   modifierFlags:0
+                                       timestamp:0
+                                    windowNumber:0
+                                         context:nil
+                                         subtype:0
+                                           data1:0
+                                           data2:0];
+    [NSApp postEvent:event atStart:YES];
+    [pool drain];
+}
+
 void _glfwPlatformSetCursorPos(_GLFWwindow* window, int x, int y)
 {
     if (window->monitor)
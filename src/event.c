@@ -0,0 +1,210 @@
+//========================================================================
+// GLFW - An OpenGL library
+// Platform:    Any
+// API version: 3.0
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2013 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+#include "internal.h"
+
+#include <stdlib.h>
+
+// The length of each of the two windows over which the smallest offset
+// between the event clock and the GLFW timer is tracked
+#define _GLFW_EVENT_CLOCK_WINDOW 10.0
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                         GLFW event API                       //////
+//////////////////////////////////////////////////////////////////////////
+
+void _glfwInputEventTime(double time)
+{
+    double offset;
+    const double now = _glfwPlatformGetTime();
+
+    if (time < 0.0)
+    {
+        _glfw.eventTime = now;
+        return;
+    }
+
+    // An event cannot be received before it occurred, so the smallest offset
+    // observed between the two clocks is the one closest to the true offset,
+    // i.e. the one with the least delivery latency.  Tracking the minimum
+    // over two consecutive windows lets old samples expire, so the estimate
+    // follows drift between the clocks
+    offset = now - time;
+
+    if (!_glfw.eventClock.calibrated)
+    {
+        _glfw.eventClock.offset[0] = offset;
+        _glfw.eventClock.offset[1] = offset;
+        _glfw.eventClock.start = now;
+        _glfw.eventClock.calibrated = GL_TRUE;
+    }
+    else if (now - _glfw.eventClock.start > _GLFW_EVENT_CLOCK_WINDOW)
+    {
+        _glfw.eventClock.offset[0] = _glfw.eventClock.offset[1];
+        _glfw.eventClock.offset[1] = offset;
+        _glfw.eventClock.start = now;
+    }
+    else if (offset < _glfw.eventClock.offset[1])
+        _glfw.eventClock.offset[1] = offset;
+
+    if (_glfw.eventClock.offset[0] < _glfw.eventClock.offset[1])
+        _glfw.eventTime = time + _glfw.eventClock.offset[0];
+    else
+        _glfw.eventTime = time + _glfw.eventClock.offset[1];
+}
+
+GLFWevent* _glfwPushEvent(_GLFWwindow* window, int type)
+{
+    GLFWevent* event;
+
+    if (_glfw.eventCount == _glfw.eventQueueSize)
+    {
+        _glfw.droppedEvents++;
+        return NULL;
+    }
+
+    event = _glfw.events + (_glfw.eventHead + _glfw.eventCount) %
+                           _glfw.eventQueueSize;
+    _glfw.eventCount++;
+
+    event->type = type;
+    event->window = (GLFWwindow*) window;
+    event->time = _glfw.eventTime;
+    return event;
+}
+
+void _glfwRemoveEvents(_GLFWwindow* window)
+{
+    int i, count = 0;
+
+    // Compact the remaining events towards the head of the queue
+    for (i = 0;  i < _glfw.eventCount;  i++)
+    {
+        const GLFWevent* event =
+            _glfw.events + (_glfw.eventHead + i) % _glfw.eventQueueSize;
+
+        if (event->window == (GLFWwindow*) window)
+            continue;
+
+        _glfw.events[(_glfw.eventHead + count) % _glfw.eventQueueSize] = *event;
+        count++;
+    }
+
+    _glfw.eventCount = count;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                        GLFW public API                       //////
+//////////////////////////////////////////////////////////////////////////
+
+GLFWAPI double glfwGetEventTime(void)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return 0.0;
+    }
+
+    return _glfw.eventTime;
+}
+
+GLFWAPI void glfwSetEventQueueSize(int size)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    if (size < 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid event queue size");
+        return;
+    }
+
+    free(_glfw.events);
+    _glfw.events = NULL;
+    _glfw.eventQueueSize = 0;
+    _glfw.eventHead = 0;
+    _glfw.eventCount = 0;
+    _glfw.droppedEvents = 0;
+
+    if (size == 0)
+        return;
+
+    _glfw.events = (GLFWevent*) calloc(size, sizeof(GLFWevent));
+    if (!_glfw.events)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return;
+    }
+
+    _glfw.eventQueueSize = size;
+}
+
+GLFWAPI int glfwGetEvents(GLFWevent* events, int count)
+{
+    int i;
+
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return 0;
+    }
+
+    if (count < 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid event count");
+        return 0;
+    }
+
+    if (count > _glfw.eventCount)
+        count = _glfw.eventCount;
+
+    for (i = 0;  i < count;  i++)
+    {
+        events[i] = _glfw.events[_glfw.eventHead];
+        _glfw.eventHead = (_glfw.eventHead + 1) % _glfw.eventQueueSize;
+    }
+
+    _glfw.eventCount -= count;
+
+    if (_glfw.droppedEvents)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY,
+                        "Event queue overflow: %u events were dropped",
+                        _glfw.droppedEvents);
+        _glfw.droppedEvents = 0;
+    }
+
+    return count;
+}
+
@@ -130,6 +130,8 @@ GLFWAPI int glfwInit(void)
 
     memset(&_glfw, 0, sizeof(_glfw));
 
+    _glfw.joystickPolling = GLFW_POLL_ON_EVENTS;
+
     if (!_glfwPlatformInit())
     {
         _glfwPlatformTerminate();
@@ -163,6 +165,8 @@ GLFWAPI void glfwTerminate(void)
 
     _glfwDestroyMonitors();
 
+    free(_glfw.events);
+
     _glfwPlatformTerminate();
 
     _glfwInitialized = GL_FALSE;
@@ -30,6 +30,8 @@
 
 #include "internal.h"
 
+#include <string.h>
+
 
 //========================================================================
 // Sets the cursor mode for the specified window
@@ -61,7 +63,14 @@ static void setCursorMode(_GLFWwindow* window, int newMode)
     window->cursorMode = newMode;
 
     if (oldMode == GLFW_CURSOR_CAPTURED)
+    {
+        // This motion is synthesized and so is not recorded
+        const GLboolean injecting = window->injecting;
+
+        window->injecting = GL_TRUE;
         _glfwInputCursorMotion(window, window->cursorPosX, window->cursorPosY);
+        window->injecting = injecting;
+    }
 }
 
 
@@ -74,17 +83,9 @@ static void setStickyKeys(_GLFWwindow* window, int enabled)
     if (window->stickyKeys == enabled)
         return;
 
+    // Release all sticky keys
     if (!enabled)
-    {
-        int i;
-
-        // Release all sticky keys
-        for (i = 0;  i <= GLFW_KEY_LAST;  i++)
-        {
-            if (window->key[i] == _GLFW_STICK)
-                window->key[i] = GLFW_RELEASE;
-        }
-    }
+        memset(window->stuckKeys, 0, sizeof(window->stuckKeys));
 
     window->stickyKeys = enabled;
 }
@@ -99,17 +100,9 @@ static void setStickyMouseButtons(_GLFWwindow* window, int enabled)
     if (window->stickyMouseButtons == enabled)
         return;
 
+    // Release all sticky mouse buttons
     if (!enabled)
-    {
-        int i;
-
-        // Release all sticky mouse buttons
-        for (i = 0;  i <= GLFW_MOUSE_BUTTON_LAST;  i++)
-        {
-            if (window->mouseButton[i] == _GLFW_STICK)
-                window->mouseButton[i] = GLFW_RELEASE;
-        }
-    }
+        window->stuckMouseButtons = 0;
 
     window->stickyMouseButtons = enabled;
 }
@@ -121,67 +114,137 @@ static void setStickyMouseButtons(_GLFWwindow* window, int enabled)
 
 void _glfwInputKey(_GLFWwindow* window, int key, int action)
 {
+    int word;
+    GLFWuint64 mask;
     GLboolean repeated = GL_FALSE;
 
+    if (!_glfwRecordInput(window, GLFW_KEY_EVENT, key, action))
+        return;
+
     if (key < 0 || key > GLFW_KEY_LAST)
         return;
 
+    word = _GLFW_BIT_WORD(key);
+    mask = _GLFW_BIT_MASK(key);
+
     // Are we trying to release an already released key?
-    if (action == GLFW_RELEASE && window->key[key] != GLFW_PRESS)
+    if (action == GLFW_RELEASE && !(window->keys[word] & mask))
         return;
 
     // Register key action
-    if (action == GLFW_RELEASE && window->stickyKeys)
-        window->key[key] = _GLFW_STICK;
+    if (action == GLFW_RELEASE)
+    {
+        window->keys[word] &= ~mask;
+
+        if (window->stickyKeys)
+            window->stuckKeys[word] |= mask;
+    }
     else
     {
-        if (action == GLFW_PRESS && window->key[key] == GLFW_PRESS)
+        if (window->keys[word] & mask)
             repeated = GL_TRUE;
 
-        window->key[key] = (char) action;
+        window->keys[word] |= mask;
+        window->keyEdges[word] |= mask;
+        window->stuckKeys[word] &= ~mask;
     }
 
-    // Call user callback function
-    if (window->callbacks.key && !repeated)
+    if (repeated)
+        return;
+
+    if (_glfw.events)
+    {
+        GLFWevent* event = _glfwPushEvent(window, GLFW_KEY_EVENT);
+        if (event)
+        {
+            event->data.key.key = key;
+            event->data.key.action = action;
+        }
+    }
+    else if (window->callbacks.key)
         window->callbacks.key((GLFWwindow*) window, key, action);
 }
 
 void _glfwInputChar(_GLFWwindow* window, int character)
 {
+    if (!_glfwRecordInput(window, GLFW_CHAR_EVENT, character, 0))
+        return;
+
     // Valid Unicode (ISO 10646) character?
     if (!((character >= 32 && character <= 126) || character >= 160))
         return;
 
-    if (window->callbacks.character)
+    if (_glfw.events)
+    {
+        GLFWevent* event = _glfwPushEvent(window, GLFW_CHAR_EVENT);
+        if (event)
+            event->data.character = character;
+    }
+    else if (window->callbacks.character)
         window->callbacks.character((GLFWwindow*) window, character);
 }
 
 void _glfwInputScroll(_GLFWwindow* window, double xoffset, double yoffset)
 {
+    if (!_glfwRecordInput(window, GLFW_SCROLL_EVENT, xoffset, yoffset))
+        return;
+
     window->scrollX += xoffset;
     window->scrollY += yoffset;
 
-    if (window->callbacks.scroll)
+    if (_glfw.events)
+    {
+        GLFWevent* event = _glfwPushEvent(window, GLFW_SCROLL_EVENT);
+        if (event)
+        {
+            event->data.scroll.x = xoffset;
+            event->data.scroll.y = yoffset;
+        }
+    }
+    else if (window->callbacks.scroll)
         window->callbacks.scroll((GLFWwindow*) window, xoffset, yoffset);
 }
 
 void _glfwInputMouseClick(_GLFWwindow* window, int button, int action)
 {
+    if (!_glfwRecordInput(window, GLFW_MOUSE_BUTTON_EVENT, button, action))
+        return;
+
     if (button < 0 || button > GLFW_MOUSE_BUTTON_LAST)
         return;
 
     // Register mouse button action
-    if (action == GLFW_RELEASE && window->stickyMouseButtons)
-        window->mouseButton[button] = _GLFW_STICK;
+    if (action == GLFW_RELEASE)
+    {
+        window->mouseButtons &= ~_GLFW_BIT_MASK(button);
+
+        if (window->stickyMouseButtons)
+            window->stuckMouseButtons |= _GLFW_BIT_MASK(button);
+    }
     else
-        window->mouseButton[button] = (char) action;
+    {
+        window->mouseButtons |= _GLFW_BIT_MASK(button);
+        window->stuckMouseButtons &= ~_GLFW_BIT_MASK(button);
+    }
 
-    if (window->callbacks.mouseButton)
+    if (_glfw.events)
+    {
+        GLFWevent* event = _glfwPushEvent(window, GLFW_MOUSE_BUTTON_EVENT);
+        if (event)
+        {
+            event->data.button.button = button;
+            event->data.button.action = action;
+        }
+    }
+    else if (window->callbacks.mouseButton)
         window->callbacks.mouseButton((GLFWwindow*) window, button, action);
 }
 
 void _glfwInputCursorMotion(_GLFWwindow* window, int x, int y)
 {
+    if (!_glfwRecordInput(window, GLFW_CURSOR_POS_EVENT, x, y))
+        return;
+
     if (window->cursorMode == GLFW_CURSOR_CAPTURED)
     {
         if (!x && !y)
@@ -199,7 +262,16 @@ void _glfwInputCursorMotion(_GLFWwindow* window, int x, int y)
         window->cursorPosY = y;
     }
 
-    if (window->callbacks.cursorPos)
+    if (_glfw.events)
+    {
+        GLFWevent* event = _glfwPushEvent(window, GLFW_CURSOR_POS_EVENT);
+        if (event)
+        {
+            event->data.pos.x = window->cursorPosX;
+            event->data.pos.y = window->cursorPosY;
+        }
+    }
+    else if (window->callbacks.cursorPos)
     {
         window->callbacks.cursorPos((GLFWwindow*) window,
                                     window->cursorPosX,
@@ -209,7 +281,16 @@ void _glfwInputCursorMotion(_GLFWwindow* window, int x, int y)
 
 void _glfwInputCursorEnter(_GLFWwindow* window, int entered)
 {
-    if (window->callbacks.cursorEnter)
+    if (!_glfwRecordInput(window, GLFW_CURSOR_ENTER_EVENT, entered, 0))
+        return;
+
+    if (_glfw.events)
+    {
+        GLFWevent* event = _glfwPushEvent(window, GLFW_CURSOR_ENTER_EVENT);
+        if (event)
+            event->data.state = entered;
+    }
+    else if (window->callbacks.cursorEnter)
         window->callbacks.cursorEnter((GLFWwindow*) window, entered);
 }
 
@@ -236,6 +317,8 @@ GLFWAPI int glfwGetInputMode(GLFWwindow* handle, int mode)
             return window->stickyKeys;
         case GLFW_STICKY_MOUSE_BUTTONS:
             return window->stickyMouseButtons;
+        case GLFW_EVENT_COMPRESSION:
+            return window->compressEvents;
         default:
             _glfwInputError(GLFW_INVALID_ENUM, NULL);
             return 0;
@@ -263,6 +346,9 @@ GLFWAPI void glfwSetInputMode(GLFWwindow* handle, int mode, int value)
         case GLFW_STICKY_MOUSE_BUTTONS:
             setStickyMouseButtons(window, value ? GL_TRUE : GL_FALSE);
             break;
+        case GLFW_EVENT_COMPRESSION:
+            window->compressEvents = value ? GL_TRUE : GL_FALSE;
+            break;
         default:
             _glfwInputError(GLFW_INVALID_ENUM, NULL);
             break;
@@ -271,6 +357,8 @@ GLFWAPI void glfwSetInputMode(GLFWwindow* handle, int mode, int value)
 
 GLFWAPI int glfwGetKey(GLFWwindow* handle, int key)
 {
+    int word;
+    GLFWuint64 mask;
     _GLFWwindow* window = (_GLFWwindow*) handle;
 
     if (!_glfwInitialized)
@@ -285,14 +373,44 @@ GLFWAPI int glfwGetKey(GLFWwindow* handle, int key)
         return GLFW_RELEASE;
     }
 
-    if (window->key[key] == _GLFW_STICK)
+    word = _GLFW_BIT_WORD(key);
+    mask = _GLFW_BIT_MASK(key);
+
+    if (window->stuckKeys[word] & mask)
     {
         // Sticky mode: release key now
-        window->key[key] = GLFW_RELEASE;
+        window->stuckKeys[word] &= ~mask;
         return GLFW_PRESS;
     }
 
-    return (int) window->key[key];
+    return (window->keys[word] & mask) ? GLFW_PRESS : GLFW_RELEASE;
+}
+
+GLFWAPI void glfwGetKeyboardState(GLFWwindow* handle,
+                                  GLFWuint64* pressed,
+                                  GLFWuint64* pressedSinceLastPoll)
+{
+    int i;
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    for (i = 0;  i < GLFW_KEY_STATE_WORDS;  i++)
+    {
+        if (pressed)
+        {
+            // Sticky mode: release keys now
+            pressed[i] = window->keys[i] | window->stuckKeys[i];
+            window->stuckKeys[i] = 0;
+        }
+
+        if (pressedSinceLastPoll)
+            pressedSinceLastPoll[i] = window->keyEdges[i];
+    }
 }
 
 GLFWAPI int glfwGetMouseButton(GLFWwindow* handle, int button)
@@ -312,14 +430,17 @@ GLFWAPI int glfwGetMouseButton(GLFWwindow* handle, int button)
         return GLFW_RELEASE;
     }
 
-    if (window->mouseButton[button] == _GLFW_STICK)
+    if (window->stuckMouseButtons & _GLFW_BIT_MASK(button))
     {
         // Sticky mode: release mouse button now
-        window->mouseButton[button] = GLFW_RELEASE;
+        window->stuckMouseButtons &= ~_GLFW_BIT_MASK(button);
         return GLFW_PRESS;
     }
 
-    return (int) window->mouseButton[button];
+    if (window->mouseButtons & _GLFW_BIT_MASK(button))
+        return GLFW_PRESS;
+
+    return GLFW_RELEASE;
 }
 
 GLFWAPI void glfwGetCursorPos(GLFWwindow* handle, int* xpos, int* ypos)
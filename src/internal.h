@@ -57,12 +57,15 @@
  #include "../support/GL/glext.h"
 #endif
 
+#include <stdio.h>
+
 typedef struct _GLFWhints       _GLFWhints;
 typedef struct _GLFWwndconfig   _GLFWwndconfig;
 typedef struct _GLFWfbconfig    _GLFWfbconfig;
 typedef struct _GLFWwindow      _GLFWwindow;
 typedef struct _GLFWlibrary     _GLFWlibrary;
 typedef struct _GLFWmonitor     _GLFWmonitor;
+typedef struct _GLFWrecord      _GLFWrecord;
 
 #if defined(_GLFW_COCOA)
  #include "cocoa_platform.h"
@@ -106,8 +109,15 @@ typedef struct _GLFWmonitor     _GLFWmonitor;
 // Helper macros
 //========================================================================
 
-// Internal key state used for sticky keys
-#define _GLFW_STICK 2
+// Bitset word index and bit mask of the specified key or mouse button
+#define _GLFW_BIT_WORD(index) ((index) / 64)
+#define _GLFW_BIT_MASK(index) ((GLFWuint64) 1 << ((index) % 64))
+
+// The number of changes kept in the history of each joystick
+#define _GLFW_JOYSTICK_HISTORY_SIZE 256
+
+// The number of axes of each joystick that can have a change threshold
+#define _GLFW_JOYSTICK_THRESHOLD_AXES 64
 
 
 //========================================================================
@@ -146,6 +156,7 @@ struct _GLFWhints
     int         glRobustness;
     int         positionX;
     int         positionY;
+    int         refreshRate;
 };
 
 
@@ -162,6 +173,7 @@ struct _GLFWwndconfig
     GLboolean     visible;
     int           positionX;
     int           positionY;
+    int           refreshRate;
     int           clientAPI;
     int           glMajor;
     int           glMinor;
@@ -198,11 +210,26 @@ struct _GLFWfbconfig
 };
 
 
+/*! @brief Input recording record.
+ *
+ *  This is also the file format of input recordings, which are a sequence of
+ *  these records in host byte order following the recording signature.
+ */
+struct _GLFWrecord
+{
+    int         type;
+    int         reserved;
+    double      time;
+    double      x, y;
+};
+
+
 /*! @brief Window and context structure.
  */
 struct _GLFWwindow
 {
     struct _GLFWwindow* next;
+    struct _GLFWwindow* prev;
 
     // Window settings and state
     int                 width, height;
@@ -218,11 +245,29 @@ struct _GLFWwindow
     // Window input state
     GLboolean           stickyKeys;
     GLboolean           stickyMouseButtons;
+    GLboolean           compressEvents;
     int                 cursorPosX, cursorPosY;
     int                 cursorMode;
     double              scrollX, scrollY;
-    char                mouseButton[GLFW_MOUSE_BUTTON_LAST + 1];
-    char                key[GLFW_KEY_LAST + 1];
+    GLFWuint64          mouseButtons;
+    GLFWuint64          stuckMouseButtons;
+    GLFWuint64          keys[GLFW_KEY_STATE_WORDS];
+    GLFWuint64          stuckKeys[GLFW_KEY_STATE_WORDS];
+    GLFWuint64          keyEdges[GLFW_KEY_STATE_WORDS];
+
+    // Input recording and replay
+    GLboolean           injecting;
+    struct {
+        FILE*           file;
+        double          start;
+    } record;
+    struct {
+        _GLFWrecord*    records;
+        int             count;
+        int             index;
+        double          start;
+        double          speed;
+    } replay;
 
     // OpenGL extensions and context attributes
     int                 clientAPI;
@@ -290,6 +335,35 @@ struct _GLFWlibrary
     int             monitorCount;
     GLFWmonitorfun  monitorCallback;
 
+    GLFWjoystickfun joystickCallback;
+    int             joystickPolling;
+    struct {
+        GLFWjoystickevent events[_GLFW_JOYSTICK_HISTORY_SIZE];
+        int         head;
+        int         count;
+        unsigned int dropped;
+    } joystickHistory[GLFW_JOYSTICK_LAST + 1];
+
+    GLFWjoystickaxisfun joystickAxisCallback;
+    GLFWjoystickbuttonfun joystickButtonCallback;
+    struct {
+        float       threshold[_GLFW_JOYSTICK_THRESHOLD_AXES];
+        float       reported[_GLFW_JOYSTICK_THRESHOLD_AXES];
+    } joystickAxes[GLFW_JOYSTICK_LAST + 1];
+
+    double          eventTime;
+    struct {
+        GLboolean   calibrated;
+        double      offset[2];
+        double      start;
+    } eventClock;
+
+    GLFWevent*      events;
+    int             eventQueueSize;
+    int             eventHead;
+    int             eventCount;
+    unsigned int    droppedEvents;
+
     GLFWgammaramp   currentRamp;
     GLFWgammaramp   originalRamp;
     int             originalRampSize;
@@ -434,6 +508,15 @@ int _glfwPlatformGetJoystickButtons(int joy, unsigned char* buttons, int numbutt
  */
 const char* _glfwPlatformGetJoystickName(int joy);
 
+/*! @brief Sets how joysticks are polled.
+ *  @param[in] mode One of @c GLFW_POLL_ON_EVENTS, @c GLFW_POLL_ON_QUERY or
+ *  @c GLFW_POLL_ON_THREAD.
+ *  @return @c GL_TRUE if successful, or @c GL_FALSE if the mode is not
+ *  supported.
+ *  @ingroup platform
+ */
+int _glfwPlatformSetJoystickPolling(int mode);
+
 /*! @brief Returns the current value of the timer.
  *  @return The value, in seconds, of the timer.
  *  @ingroup platform
@@ -488,6 +571,20 @@ void _glfwPlatformPollEvents(void);
  */
 void _glfwPlatformWaitEvents(void);
 
+/*! @brief Waits until events are pending or the timeout has elapsed, and then
+ *  processes all pending events.
+ *  @param[in] timeout The maximum time, in seconds, to wait.
+ *  @ingroup platform
+ */
+void _glfwPlatformWaitEventsTimeout(double timeout);
+
+/*! @brief Posts an empty event that wakes up a blocked event wait.
+ *  @ingroup platform
+ *
+ *  @note This function may be called from secondary threads.
+ */
+void _glfwPlatformPostEmptyEvent(void);
+
 /*! @ingroup platform
  */
 void _glfwPlatformMakeContextCurrent(_GLFWwindow* window);
@@ -628,10 +725,88 @@ void _glfwInputCursorMotion(_GLFWwindow* window, int x, int y);
  */
 void _glfwInputCursorEnter(_GLFWwindow* window, int entered);
 
-/*! @ingroup event
+/*! @brief Notifies shared code that the monitor configuration has changed,
+ *  making it retrieve and compare every monitor.
+ *  @ingroup event
  */
 void _glfwInputMonitorChange(void);
 
+/*! @brief Notifies shared code that a monitor has been connected.
+ *  @param[in] monitor The newly created monitor, which shared code takes
+ *  ownership of.
+ *  @ingroup event
+ */
+void _glfwInputMonitorConnect(_GLFWmonitor* monitor);
+
+/*! @brief Notifies shared code that a monitor has been disconnected.
+ *  @param[in] monitor The monitor that was disconnected.  It is destroyed by
+ *  this function.
+ *  @ingroup event
+ */
+void _glfwInputMonitorDisconnect(_GLFWmonitor* monitor);
+
+/*! @brief Notifies shared code of a joystick connection or disconnection.
+ *  @param[in] joy The joystick that was connected or disconnected.
+ *  @param[in] event One of @c GLFW_CONNECTED or @c GLFW_DISCONNECTED.
+ *  @ingroup event
+ */
+void _glfwInputJoystickChange(int joy, int event);
+
+/*! @brief Notifies shared code of a change of a joystick axis.
+ *  @param[in] joy The joystick whose axis changed.
+ *  @param[in] axis The axis that changed.
+ *  @param[in] value The new position of the axis.
+ *  @param[in] time The time of the change, on the GLFW timebase.
+ *  @ingroup event
+ */
+void _glfwInputJoystickAxis(int joy, int axis, float value, double time);
+
+/*! @brief Notifies shared code of a change of a joystick button.
+ *  @param[in] joy The joystick whose button changed.
+ *  @param[in] button The button that changed.
+ *  @param[in] action Either @c GLFW_PRESS or @c GLFW_RELEASE.
+ *  @param[in] time The time of the change, on the GLFW timebase.
+ *  @ingroup event
+ */
+void _glfwInputJoystickButton(int joy, int button, int action, double time);
+
+/*! @brief Notifies shared code of the time of the event about to be reported.
+ *  @param[in] time The timestamp of the event, in seconds on the clock of the
+ *  window system, or a negative value if the event has no timestamp.
+ *  @ingroup event
+ */
+void _glfwInputEventTime(double time);
+
+/*! @brief Records window system input for the specified window.
+ *  @param[in] window The window that received the input.
+ *  @param[in] type The type of the input, as a @c GLFW_*_EVENT token.
+ *  @param[in] x The first parameter of the input.
+ *  @param[in] y The second parameter of the input.
+ *  @return @c GL_TRUE if the input should be processed, or @c GL_FALSE if it
+ *  should be discarded because input is being replayed to the window.
+ *  @ingroup event
+ *
+ *  Input generated by shared code or by a replay is neither recorded nor
+ *  discarded.
+ */
+GLboolean _glfwRecordInput(_GLFWwindow* window, int type, double x, double y);
+
+/*! @brief Adds an event record to the event queue.
+ *  @param[in] window The window that received the event.
+ *  @param[in] type The type of the event.
+ *  @return The event record to fill in, or @c NULL if the queue is full.
+ *  @ingroup event
+ *
+ *  @note This function may only be called while the event queue is enabled.
+ */
+GLFWevent* _glfwPushEvent(_GLFWwindow* window, int type);
+
+/*! @brief Removes all queued events for the specified window.
+ *  @param[in] window The window whose events to remove.
+ *  @ingroup event
+ */
+void _glfwRemoveEvents(_GLFWwindow* window);
+
 /*! @brief Notifies shared code of an error.
  *  @param[in] error The error code most suitable for the error.
  *  @param[in] format The @c printf style format string of the error
@@ -645,6 +820,24 @@ void _glfwInputError(int error, const char* format, ...);
 // Utility functions
 //========================================================================
 
+/*! @brief Delivers all replayed input that is due.
+ *  @ingroup utility
+ */
+void _glfwPollReplay(void);
+
+/*! @brief Returns the time until replayed input is next due.
+ *  @return The time until replayed input is next due, in seconds, or a
+ *  negative value if no input is being replayed.
+ *  @ingroup utility
+ */
+double _glfwGetReplayTimeout(void);
+
+/*! @brief Stops any input recording and replay for the specified window.
+ *  @param[in] window The window whose recording and replay to stop.
+ *  @ingroup utility
+ */
+void _glfwStopRecording(_GLFWwindow* window);
+
 /*! @ingroup utility
  */
 const GLFWvidmode* _glfwChooseVideoMode(_GLFWmonitor* monitor,
@@ -710,4 +903,10 @@ void _glfwDestroyMonitor(_GLFWmonitor* monitor);
   */
 void _glfwDestroyMonitors(void);
 
+/*! @brief Discards the cached video modes of the specified monitor.
+ *  @param[in] monitor The monitor whose modes may have changed.
+ *  @ingroup utility
+ */
+void _glfwInvalidateVideoModes(_GLFWmonitor* monitor);
+
 #endif // _internal_h_
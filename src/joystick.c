@@ -30,6 +30,99 @@
 
 #include "internal.h"
 
+#include <string.h>
+
+
+//========================================================================
+// Adds a change to the history of the specified joystick
+//========================================================================
+
+static GLFWjoystickevent* pushJoystickEvent(int joy, int type, int index,
+                                            double time)
+{
+    GLFWjoystickevent* event;
+
+    if (_glfw.joystickHistory[joy].count == _GLFW_JOYSTICK_HISTORY_SIZE)
+    {
+        // Discard the oldest change, as the history is a record of the
+        // most recent input
+        _glfw.joystickHistory[joy].head = (_glfw.joystickHistory[joy].head + 1) %
+                                          _GLFW_JOYSTICK_HISTORY_SIZE;
+        _glfw.joystickHistory[joy].count--;
+        _glfw.joystickHistory[joy].dropped++;
+    }
+
+    event = _glfw.joystickHistory[joy].events +
+            (_glfw.joystickHistory[joy].head + _glfw.joystickHistory[joy].count) %
+            _GLFW_JOYSTICK_HISTORY_SIZE;
+    _glfw.joystickHistory[joy].count++;
+
+    event->type = type;
+    event->index = index;
+    event->time = time;
+    return event;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                         GLFW event API                       //////
+//////////////////////////////////////////////////////////////////////////
+
+void _glfwInputJoystickChange(int joy, int event)
+{
+    // Changes from a previous joystick in this slot are of no use
+    if (event == GLFW_CONNECTED)
+    {
+        _glfw.joystickHistory[joy].head = 0;
+        _glfw.joystickHistory[joy].count = 0;
+        _glfw.joystickHistory[joy].dropped = 0;
+
+        memset(_glfw.joystickAxes[joy].reported, 0,
+               sizeof(_glfw.joystickAxes[joy].reported));
+    }
+
+    if (_glfw.joystickCallback)
+        _glfw.joystickCallback(joy, event);
+}
+
+void _glfwInputJoystickAxis(int joy, int axis, float value, double time)
+{
+    GLFWjoystickevent* event;
+
+    event = pushJoystickEvent(joy, GLFW_JOYSTICK_AXIS_EVENT, axis, time);
+    event->data.value = value;
+
+    if (axis < _GLFW_JOYSTICK_THRESHOLD_AXES)
+    {
+        const float threshold = _glfw.joystickAxes[joy].threshold[axis];
+        const float delta = value - _glfw.joystickAxes[joy].reported[axis];
+
+        // Small movements are dropped, except onto the center or an end,
+        // so that an axis at rest is always reported as such
+        if (delta < threshold && delta > -threshold &&
+            value != 0.f && value != 1.f && value != -1.f)
+        {
+            return;
+        }
+
+        _glfw.joystickAxes[joy].reported[axis] = value;
+    }
+
+    if (_glfw.joystickAxisCallback)
+        _glfw.joystickAxisCallback(joy, axis, value);
+}
+
+void _glfwInputJoystickButton(int joy, int button, int action, double time)
+{
+    GLFWjoystickevent* event;
+
+    event = pushJoystickEvent(joy, GLFW_JOYSTICK_BUTTON_EVENT, button, time);
+    event->data.action = action;
+
+    if (_glfw.joystickButtonCallback)
+        _glfw.joystickButtonCallback(joy, button, action);
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                        GLFW public API                       //////
@@ -129,3 +222,145 @@ GLFWAPI const char* glfwGetJoystickName(int joy)
     return _glfwPlatformGetJoystickName(joy);
 }
 
+GLFWAPI int glfwGetJoystickEvents(int joy, GLFWjoystickevent* events, int count)
+{
+    int i;
+
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return 0;
+    }
+
+    if (joy < 0 || joy > GLFW_JOYSTICK_LAST)
+    {
+        _glfwInputError(GLFW_INVALID_ENUM, NULL);
+        return 0;
+    }
+
+    if (events == NULL || count < 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, NULL);
+        return 0;
+    }
+
+    if (count > _glfw.joystickHistory[joy].count)
+        count = _glfw.joystickHistory[joy].count;
+
+    for (i = 0;  i < count;  i++)
+    {
+        events[i] = _glfw.joystickHistory[joy].events[_glfw.joystickHistory[joy].head];
+        _glfw.joystickHistory[joy].head = (_glfw.joystickHistory[joy].head + 1) %
+                                          _GLFW_JOYSTICK_HISTORY_SIZE;
+    }
+
+    _glfw.joystickHistory[joy].count -= count;
+
+    if (_glfw.joystickHistory[joy].dropped)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY,
+                        "Joystick history overflow: %u changes were dropped",
+                        _glfw.joystickHistory[joy].dropped);
+        _glfw.joystickHistory[joy].dropped = 0;
+    }
+
+    return count;
+}
+
+GLFWAPI void glfwJoystickHint(int target, int hint)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    switch (target)
+    {
+        case GLFW_JOYSTICK_POLLING:
+            if (hint != GLFW_POLL_ON_EVENTS &&
+                hint != GLFW_POLL_ON_QUERY &&
+                hint != GLFW_POLL_ON_THREAD)
+            {
+                _glfwInputError(GLFW_INVALID_ENUM,
+                                "Invalid joystick polling mode");
+                return;
+            }
+
+            if (hint == _glfw.joystickPolling)
+                return;
+
+            if (!_glfwPlatformSetJoystickPolling(hint))
+                return;
+
+            _glfw.joystickPolling = hint;
+            break;
+
+        default:
+            _glfwInputError(GLFW_INVALID_ENUM, NULL);
+            break;
+    }
+}
+
+GLFWAPI void glfwSetJoystickCallback(GLFWjoystickfun cbfun)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    _glfw.joystickCallback = cbfun;
+}
+
+GLFWAPI void glfwSetJoystickAxisCallback(GLFWjoystickaxisfun cbfun)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    _glfw.joystickAxisCallback = cbfun;
+}
+
+GLFWAPI void glfwSetJoystickButtonCallback(GLFWjoystickbuttonfun cbfun)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    _glfw.joystickButtonCallback = cbfun;
+}
+
+GLFWAPI void glfwSetJoystickAxisThreshold(int joy, int axis, float threshold)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    if (joy < 0 || joy > GLFW_JOYSTICK_LAST)
+    {
+        _glfwInputError(GLFW_INVALID_ENUM, NULL);
+        return;
+    }
+
+    if (axis < 0 || axis >= _GLFW_JOYSTICK_THRESHOLD_AXES)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid joystick axis");
+        return;
+    }
+
+    if (threshold != threshold || threshold < 0.f)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid joystick axis threshold");
+        return;
+    }
+
+    _glfw.joystickAxes[joy].threshold[axis] = threshold;
+}
+
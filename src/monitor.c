@@ -67,25 +67,34 @@ static int compareVideoModes(const void* firstPtr, const void* secondPtr)
     firstSize = first->width * first->height;
     secondSize = second->width * second->height;
 
-    return firstSize - secondSize;
+    if (firstSize != secondSize)
+        return firstSize - secondSize;
+
+    // Lastly sort on refresh rate
+
+    return first->refreshRate - second->refreshRate;
 }
 
 
 //========================================================================
-// Retrieves the available modes for the specified monitor
+// Retrieves the available modes for the specified monitor, unless they
+// are already cached
 //========================================================================
 
 static int refreshVideoModes(_GLFWmonitor* monitor)
 {
     int modeCount;
+    GLFWvidmode* modes;
+
+    if (monitor->modes)
+        return GL_TRUE;
 
-    GLFWvidmode* modes = _glfwPlatformGetVideoModes(monitor, &modeCount);
+    modes = _glfwPlatformGetVideoModes(monitor, &modeCount);
     if (!modes)
         return GL_FALSE;
 
     qsort(modes, modeCount, sizeof(GLFWvidmode), compareVideoModes);
 
-    free(monitor->modes);
     monitor->modes = modes;
     monitor->modeCount = modeCount;
 
@@ -149,8 +158,14 @@ void _glfwInputMonitorChange(void)
             {
                 // This monitor was connected before, so re-use the existing
                 // monitor object to preserve its address and user pointer
+                _glfw.monitors[j]->primary = monitors[i]->primary;
+                _glfw.monitors[j]->widthMM = monitors[i]->widthMM;
+                _glfw.monitors[j]->heightMM = monitors[i]->heightMM;
+                _glfw.monitors[j]->positionX = monitors[i]->positionX;
+                _glfw.monitors[j]->positionY = monitors[i]->positionY;
 
-                // TODO: Transfer monitor properties
+                // The change may have affected its modes
+                _glfwInvalidateVideoModes(_glfw.monitors[j]);
 
                 _glfwDestroyMonitor(monitors[i]);
                 monitors[i] = _glfw.monitors[j];
@@ -162,7 +177,8 @@ void _glfwInputMonitorChange(void)
         if (j == _glfw.monitorCount)
         {
             // This monitor was not connected before
-            _glfw.monitorCallback((GLFWmonitor*) monitors[i], GLFW_CONNECTED);
+            if (_glfw.monitorCallback)
+                _glfw.monitorCallback((GLFWmonitor*) monitors[i], GLFW_CONNECTED);
         }
     }
 
@@ -174,7 +190,8 @@ void _glfwInputMonitorChange(void)
             continue;
 
         // This monitor is no longer connected
-        _glfw.monitorCallback((GLFWmonitor*) _glfw.monitors[i], GLFW_DISCONNECTED);
+        if (_glfw.monitorCallback)
+            _glfw.monitorCallback((GLFWmonitor*) _glfw.monitors[i], GLFW_DISCONNECTED);
 
         for (window = _glfw.windowListHead;  window;  window = window->next)
         {
@@ -189,6 +206,61 @@ void _glfwInputMonitorChange(void)
     _glfw.monitorCount = monitorCount;
 }
 
+void _glfwInputMonitorConnect(_GLFWmonitor* monitor)
+{
+    _GLFWmonitor** monitors;
+
+    monitors = (_GLFWmonitor**) realloc(_glfw.monitors,
+                                        sizeof(_GLFWmonitor*) *
+                                        (_glfw.monitorCount + 1));
+    if (!monitors)
+    {
+        _glfwDestroyMonitor(monitor);
+
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return;
+    }
+
+    _glfw.monitors = monitors;
+    _glfw.monitors[_glfw.monitorCount] = monitor;
+    _glfw.monitorCount++;
+
+    if (_glfw.monitorCallback)
+        _glfw.monitorCallback((GLFWmonitor*) monitor, GLFW_CONNECTED);
+}
+
+void _glfwInputMonitorDisconnect(_GLFWmonitor* monitor)
+{
+    int i;
+    _GLFWwindow* window;
+
+    for (i = 0;  i < _glfw.monitorCount;  i++)
+    {
+        if (_glfw.monitors[i] == monitor)
+            break;
+    }
+
+    if (i == _glfw.monitorCount)
+        return;
+
+    // The remaining monitors keep their order
+    _glfw.monitorCount--;
+    memmove(_glfw.monitors + i,
+            _glfw.monitors + i + 1,
+            sizeof(_GLFWmonitor*) * (_glfw.monitorCount - i));
+
+    if (_glfw.monitorCallback)
+        _glfw.monitorCallback((GLFWmonitor*) monitor, GLFW_DISCONNECTED);
+
+    for (window = _glfw.windowListHead;  window;  window = window->next)
+    {
+        if (window->monitor == monitor)
+            window->monitor = NULL;
+    }
+
+    _glfwDestroyMonitor(monitor);
+}
+
 void _glfwDestroyMonitors(void)
 {
     int i;
@@ -201,12 +273,20 @@ void _glfwDestroyMonitors(void)
     _glfw.monitorCount = 0;
 }
 
+void _glfwInvalidateVideoModes(_GLFWmonitor* monitor)
+{
+    free(monitor->modes);
+    monitor->modes = NULL;
+    monitor->modeCount = 0;
+}
+
 const GLFWvidmode* _glfwChooseVideoMode(_GLFWmonitor* monitor,
                                         const GLFWvidmode* desired)
 {
     int i;
     unsigned int sizeDiff, leastSizeDiff = UINT_MAX;
     unsigned int colorDiff, leastColorDiff = UINT_MAX;
+    unsigned int rateDiff, leastRateDiff = UINT_MAX;
     const GLFWvidmode* current;
     const GLFWvidmode* closest = NULL;
 
@@ -225,12 +305,21 @@ const GLFWvidmode* _glfwChooseVideoMode(_GLFWmonitor* monitor,
                        (current->height - desired->height) *
                        (current->height - desired->height));
 
+        // A desired refresh rate of zero means the highest available
+        if (desired->refreshRate)
+            rateDiff = abs(current->refreshRate - desired->refreshRate);
+        else
+            rateDiff = UINT_MAX - current->refreshRate;
+
         if ((colorDiff < leastColorDiff) ||
-            (colorDiff == leastColorDiff && sizeDiff < leastSizeDiff))
+            (colorDiff == leastColorDiff && sizeDiff < leastSizeDiff) ||
+            (colorDiff == leastColorDiff && sizeDiff == leastSizeDiff &&
+             rateDiff < leastRateDiff))
         {
             closest = current;
             leastSizeDiff = sizeDiff;
             leastColorDiff = colorDiff;
+            leastRateDiff = rateDiff;
         }
     }
 
@@ -369,7 +458,7 @@ GLFWAPI const GLFWvidmode* glfwGetVideoModes(GLFWmonitor* handle, int* count)
     }
 
     if (!refreshVideoModes(monitor))
-        return GL_FALSE;
+        return NULL;
 
     *count = monitor->modeCount;
     return monitor->modes;
@@ -378,7 +467,7 @@ GLFWAPI const GLFWvidmode* glfwGetVideoModes(GLFWmonitor* handle, int* count)
 GLFWAPI GLFWvidmode glfwGetVideoMode(GLFWmonitor* handle)
 {
     _GLFWmonitor* monitor = (_GLFWmonitor*) handle;
-    GLFWvidmode mode = { 0, 0, 0, 0, 0 };
+    GLFWvidmode mode = { 0, 0, 0, 0, 0, 0 };
 
     if (!_glfwInitialized)
     {
@@ -0,0 +1,418 @@
+//========================================================================
+// GLFW - An OpenGL library
+// Platform:    Any
+// API version: 3.0
+// WWW:         http://www.glfw.org/
+//------------------------------------------------------------------------
+// Copyright (c) 2013 Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+#include "internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// The signature at the start of every input recording, including the format
+// version in its last byte
+#define _GLFW_RECORD_SIGNATURE "GLFWREC\001"
+#define _GLFW_RECORD_SIGNATURE_SIZE 8
+
+
+//========================================================================
+// Returns the time at which the specified replayed record is due
+//========================================================================
+
+static double getReplayTime(const _GLFWwindow* window,
+                            const _GLFWrecord* record)
+{
+    if (window->replay.speed == 0.0)
+        return window->replay.start;
+
+    return window->replay.start + record->time / window->replay.speed;
+}
+
+
+//========================================================================
+// Passes the specified replayed record to the event API
+//========================================================================
+
+static void injectRecord(_GLFWwindow* window, const _GLFWrecord* record)
+{
+    const int x = (int) record->x;
+    const int y = (int) record->y;
+
+    switch (record->type)
+    {
+        case GLFW_WINDOW_POS_EVENT:
+            _glfwInputWindowPos(window, x, y);
+            break;
+        case GLFW_WINDOW_SIZE_EVENT:
+            _glfwInputWindowSize(window, x, y);
+            break;
+        case GLFW_WINDOW_CLOSE_EVENT:
+            _glfwInputWindowCloseRequest(window);
+            break;
+        case GLFW_WINDOW_REFRESH_EVENT:
+            _glfwInputWindowDamage(window);
+            break;
+        case GLFW_WINDOW_FOCUS_EVENT:
+            _glfwInputWindowFocus(window, x ? GL_TRUE : GL_FALSE);
+            break;
+        case GLFW_WINDOW_ICONIFY_EVENT:
+            _glfwInputWindowIconify(window, x);
+            break;
+        case GLFW_KEY_EVENT:
+            _glfwInputKey(window, x, y);
+            break;
+        case GLFW_CHAR_EVENT:
+            _glfwInputChar(window, x);
+            break;
+        case GLFW_MOUSE_BUTTON_EVENT:
+            _glfwInputMouseClick(window, x, y);
+            break;
+        case GLFW_CURSOR_POS_EVENT:
+            _glfwInputCursorMotion(window, x, y);
+            break;
+        case GLFW_CURSOR_ENTER_EVENT:
+            _glfwInputCursorEnter(window, x);
+            break;
+        case GLFW_SCROLL_EVENT:
+            _glfwInputScroll(window, record->x, record->y);
+            break;
+    }
+}
+
+
+//========================================================================
+// Stops any replay to the specified window and frees its recording
+//========================================================================
+
+static void stopReplay(_GLFWwindow* window)
+{
+    free(window->replay.records);
+    window->replay.records = NULL;
+    window->replay.count = 0;
+    window->replay.index = 0;
+}
+
+
+//========================================================================
+// Returns whether the specified window still exists
+//========================================================================
+
+static GLboolean isWindowListed(const _GLFWwindow* window)
+{
+    const _GLFWwindow* listed;
+
+    for (listed = _glfw.windowListHead;  listed;  listed = listed->next)
+    {
+        if (listed == window)
+            return GL_TRUE;
+    }
+
+    return GL_FALSE;
+}
+
+
+//========================================================================
+// Delivers the replayed input to the specified window that is due
+// Returns GL_FALSE if a callback destroyed the window
+//========================================================================
+
+static GLboolean pollWindowReplay(_GLFWwindow* window, double now)
+{
+    while (window->replay.index < window->replay.count)
+    {
+        const _GLFWrecord* record =
+            window->replay.records + window->replay.index;
+        const double time = getReplayTime(window, record);
+
+        if (time > now)
+            break;
+
+        // Replayed events report their scaled recording time
+        _glfw.eventTime = time;
+
+        // The record is consumed before the callbacks run, as they may stop
+        // or restart the replay
+        window->replay.index++;
+
+        window->injecting = GL_TRUE;
+        injectRecord(window, record);
+
+        if (!isWindowListed(window))
+            return GL_FALSE;
+
+        window->injecting = GL_FALSE;
+    }
+
+    if (window->replay.records &&
+        window->replay.index == window->replay.count)
+    {
+        stopReplay(window);
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Loads the specified input recording
+//========================================================================
+
+static _GLFWrecord* loadRecording(const char* path, int* count)
+{
+    FILE* file;
+    long size;
+    char signature[_GLFW_RECORD_SIGNATURE_SIZE];
+    _GLFWrecord* records;
+
+    file = fopen(path, "rb");
+    if (!file)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to open input recording %s", path);
+        return NULL;
+    }
+
+    if (fread(signature, sizeof(signature), 1, file) != 1 ||
+        memcmp(signature, _GLFW_RECORD_SIGNATURE, sizeof(signature)) != 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "File %s is not a valid input recording", path);
+        fclose(file);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    size = ftell(file) - (long) sizeof(signature);
+    fseek(file, (long) sizeof(signature), SEEK_SET);
+
+    *count = (int) (size / (long) sizeof(_GLFWrecord));
+    if (*count == 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "Input recording %s is empty", path);
+        fclose(file);
+        return NULL;
+    }
+
+    records = (_GLFWrecord*) malloc(*count * sizeof(_GLFWrecord));
+    if (!records)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        fclose(file);
+        return NULL;
+    }
+
+    if (fread(records, sizeof(_GLFWrecord), *count, file) != (size_t) *count)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to read input recording %s", path);
+        free(records);
+        fclose(file);
+        return NULL;
+    }
+
+    fclose(file);
+    return records;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                         GLFW event API                       //////
+//////////////////////////////////////////////////////////////////////////
+
+GLboolean _glfwRecordInput(_GLFWwindow* window, int type, double x, double y)
+{
+    _GLFWrecord record;
+
+    if (window->injecting)
+        return GL_TRUE;
+
+    if (window->replay.records)
+        return GL_FALSE;
+
+    if (!window->record.file)
+        return GL_TRUE;
+
+    record.type = type;
+    record.reserved = 0;
+    record.time = _glfw.eventTime - window->record.start;
+    record.x = x;
+    record.y = y;
+
+    if (fwrite(&record, sizeof(record), 1, window->record.file) != 1)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to write input recording");
+
+        fclose(window->record.file);
+        window->record.file = NULL;
+    }
+
+    return GL_TRUE;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                       GLFW internal API                      //////
+//////////////////////////////////////////////////////////////////////////
+
+void _glfwPollReplay(void)
+{
+    _GLFWwindow* window = _glfw.windowListHead;
+    const double now = _glfwPlatformGetTime();
+
+    while (window)
+    {
+        if (!pollWindowReplay(window, now))
+        {
+            // Callbacks may destroy any window, so the list is walked again
+            // from the start, which skips the records already delivered
+            window = _glfw.windowListHead;
+            continue;
+        }
+
+        window = window->next;
+    }
+}
+
+double _glfwGetReplayTimeout(void)
+{
+    _GLFWwindow* window;
+    double timeout = -1.0;
+    const double now = _glfwPlatformGetTime();
+
+    for (window = _glfw.windowListHead;  window;  window = window->next)
+    {
+        double time;
+
+        if (!window->replay.records)
+            continue;
+
+        time = getReplayTime(window,
+                             window->replay.records + window->replay.index);
+
+        if (time < now)
+            return 0.0;
+
+        if (timeout < 0.0 || time - now < timeout)
+            timeout = time - now;
+    }
+
+    return timeout;
+}
+
+void _glfwStopRecording(_GLFWwindow* window)
+{
+    if (window->record.file)
+    {
+        fclose(window->record.file);
+        window->record.file = NULL;
+    }
+
+    stopReplay(window);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                        GLFW public API                       //////
+//////////////////////////////////////////////////////////////////////////
+
+GLFWAPI int glfwRecordInput(GLFWwindow* handle, const char* path)
+{
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return GL_FALSE;
+    }
+
+    if (window->record.file)
+    {
+        fclose(window->record.file);
+        window->record.file = NULL;
+    }
+
+    if (!path)
+        return GL_TRUE;
+
+    window->record.file = fopen(path, "wb");
+    if (!window->record.file)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to create input recording %s", path);
+        return GL_FALSE;
+    }
+
+    if (fwrite(_GLFW_RECORD_SIGNATURE, _GLFW_RECORD_SIGNATURE_SIZE, 1,
+               window->record.file) != 1)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to write input recording %s", path);
+
+        fclose(window->record.file);
+        window->record.file = NULL;
+        return GL_FALSE;
+    }
+
+    window->record.start = _glfwPlatformGetTime();
+    return GL_TRUE;
+}
+
+GLFWAPI int glfwReplayInput(GLFWwindow* handle, const char* path, double speed)
+{
+    int count;
+    _GLFWrecord* records;
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return GL_FALSE;
+    }
+
+    if (speed != speed || speed < 0.0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid replay speed");
+        return GL_FALSE;
+    }
+
+    stopReplay(window);
+
+    if (!path)
+        return GL_TRUE;
+
+    records = loadRecording(path, &count);
+    if (!records)
+        return GL_FALSE;
+
+    window->replay.records = records;
+    window->replay.count = count;
+    window->replay.start = _glfwPlatformGetTime();
+    window->replay.speed = speed;
+    return GL_TRUE;
+}
+
@@ -181,6 +181,9 @@ int _glfwPlatformInit(void)
 
     _glfw.win32.instance = GetModuleHandle(NULL);
 
+    // Remember the main thread so empty events can be posted to its queue
+    _glfw.win32.mainThreadID = GetCurrentThreadId();
+
     // Save the original gamma ramp
     _glfw.originalRampSize = 256;
     _glfwPlatformGetGammaRamp(&_glfw.originalRamp);
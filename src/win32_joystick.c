@@ -248,3 +248,15 @@ const char* _glfwPlatformGetJoystickName(int joy)
     return _glfw.win32.joystick[i].name;
 }
 
+int _glfwPlatformSetJoystickPolling(int mode)
+{
+    if (mode == GLFW_POLL_ON_THREAD)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Win32: Joystick polling on a thread is not supported");
+        return GL_FALSE;
+    }
+
+    return GL_TRUE;
+}
+
@@ -44,6 +44,20 @@
 #endif
 
 
+//========================================================================
+// Returns the refresh rate of the specified display settings
+//========================================================================
+
+static int getRefreshRate(const DEVMODE* dm)
+{
+    // Zero and one both mean the hardware default rate
+    if (dm->dmDisplayFrequency <= 1)
+        return 0;
+
+    return dm->dmDisplayFrequency;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW internal API                      //////
 //////////////////////////////////////////////////////////////////////////
@@ -73,6 +87,12 @@ int _glfwSetVideoMode(_GLFWmonitor* monitor, const GLFWvidmode* mode)
     if (dm.dmBitsPerPel < 15 || dm.dmBitsPerPel >= 24)
         dm.dmBitsPerPel = 32;
 
+    if (best->refreshRate)
+    {
+        dm.dmFields |= DM_DISPLAYFREQUENCY;
+        dm.dmDisplayFrequency = best->refreshRate;
+    }
+
     if (ChangeDisplaySettingsEx(monitor->win32.name,
                                 &dm,
                                 NULL,
@@ -227,6 +247,7 @@ GLFWvidmode* _glfwPlatformGetVideoModes(_GLFWmonitor* monitor, int* found)
 
         mode.width = dm.dmPelsWidth;
         mode.height = dm.dmPelsHeight;
+        mode.refreshRate = getRefreshRate(&dm);
         _glfwSplitBPP(dm.dmBitsPerPel,
                       &mode.redBits,
                       &mode.greenBits,
@@ -283,6 +304,7 @@ void _glfwPlatformGetVideoMode(_GLFWmonitor* monitor, GLFWvidmode* mode)
 
     mode->width  = dm.dmPelsWidth;
     mode->height = dm.dmPelsHeight;
+    mode->refreshRate = getRefreshRate(&dm);
     _glfwSplitBPP(dm.dmBitsPerPel,
                   &mode->redBits,
                   &mode->greenBits,
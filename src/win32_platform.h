@@ -160,6 +160,9 @@ typedef struct _GLFWlibraryWin32
     HINSTANCE           instance;
     ATOM                classAtom;
     DWORD               foregroundLockTimeout;
+    DWORD               mainThreadID;
+    DWORD               lastMessageTime;
+    double              messageTime;
     char*               clipboardString;
 
     // Timer data
@@ -307,6 +307,40 @@ static int translateKey(WPARAM wParam, LPARAM lParam)
 }
 
 
+//========================================================================
+// Returns the message time of the specified message, in seconds
+//========================================================================
+
+static double getMessageTime(UINT uMsg)
+{
+    DWORD time;
+
+    // Only posted input messages carry a meaningful message time
+    if ((uMsg < WM_KEYFIRST || uMsg > WM_KEYLAST) &&
+        (uMsg < WM_MOUSEFIRST || uMsg > WM_MOUSELAST) &&
+        uMsg != WM_MOUSELEAVE)
+    {
+        return -1.0;
+    }
+
+    // The message time is a 32-bit millisecond counter that wraps around
+    // after about 49.7 days, so accumulate the signed difference since the
+    // last message time instead of using it directly
+    time = (DWORD) GetMessageTime();
+
+    if (_glfw.win32.lastMessageTime)
+    {
+        _glfw.win32.messageTime +=
+            (LONG) (time - _glfw.win32.lastMessageTime) / 1000.0;
+    }
+    else
+        _glfw.win32.messageTime = time / 1000.0;
+
+    _glfw.win32.lastMessageTime = time;
+    return _glfw.win32.messageTime;
+}
+
+
 //========================================================================
 // Window callback function (handles window events)
 //========================================================================
@@ -316,6 +350,8 @@ static LRESULT CALLBACK windowProc(HWND hWnd, UINT uMsg,
 {
     _GLFWwindow* window = (_GLFWwindow*) GetWindowLongPtr(hWnd, 0);
 
+    _glfwInputEventTime(getMessageTime(uMsg));
+
     switch (uMsg)
     {
         case WM_CREATE:
@@ -1024,11 +1060,19 @@ void _glfwPlatformPollEvents(void)
 
         // See if this differs from our belief of what has happened
         // (we only have to check for lost key up events)
-        if (!lshift_down && window->key[GLFW_KEY_LEFT_SHIFT] == 1)
+        if (!lshift_down &&
+            (window->keys[_GLFW_BIT_WORD(GLFW_KEY_LEFT_SHIFT)] &
+             _GLFW_BIT_MASK(GLFW_KEY_LEFT_SHIFT)))
+        {
             _glfwInputKey(window, GLFW_KEY_LEFT_SHIFT, GLFW_RELEASE);
+        }
 
-        if (!rshift_down && window->key[GLFW_KEY_RIGHT_SHIFT] == 1)
+        if (!rshift_down &&
+            (window->keys[_GLFW_BIT_WORD(GLFW_KEY_RIGHT_SHIFT)] &
+             _GLFW_BIT_MASK(GLFW_KEY_RIGHT_SHIFT)))
+        {
             _glfwInputKey(window, GLFW_KEY_RIGHT_SHIFT, GLFW_RELEASE);
+        }
     }
 
     // Did the cursor move in an focused window that has captured the cursor
@@ -1053,6 +1097,28 @@ void _glfwPlatformWaitEvents(void)
     _glfwPlatformPollEvents();
 }
 
+void _glfwPlatformWaitEventsTimeout(double timeout)
+{
+    DWORD milliseconds;
+
+    // Clamp before the cast, so that a large timeout neither wraps around
+    // nor turns into INFINITE
+    if (timeout * 1e3 >= (double) (INFINITE - 1))
+        milliseconds = INFINITE - 1;
+    else
+        milliseconds = (DWORD) (timeout * 1e3);
+
+    MsgWaitForMultipleObjects(0, NULL, FALSE, milliseconds, QS_ALLEVENTS);
+
+    _glfwPlatformPollEvents();
+}
+
+void _glfwPlatformPostEmptyEvent(void)
+{
+    // A thread message has no window, so DispatchMessage ignores it
+    PostThreadMessage(_glfw.win32.mainThreadID, WM_NULL, 0, 0);
+}
+
 void _glfwPlatformSetCursorPos(_GLFWwindow* window, int x, int y)
 {
     POINT pos;
@@ -49,10 +49,10 @@ static int Max(int a, int b)
 
 
 //========================================================================
-// Clear scroll offsets for all windows
+// Clear scroll offsets and key press edges for all windows
 //========================================================================
 
-static void clearScrollOffsets(void)
+static void clearPollState(void)
 {
     _GLFWwindow* window;
 
@@ -60,7 +60,48 @@ static void clearScrollOffsets(void)
     {
         window->scrollX = 0;
         window->scrollY = 0;
+
+        memset(window->keyEdges, 0, sizeof(window->keyEdges));
+    }
+}
+
+
+//========================================================================
+// Returns the index of the lowest set bit in the specified non-zero bitset
+//========================================================================
+
+static int findLowestBit(GLFWuint64 bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    int index = 0;
+
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        index++;
+    }
+
+    return index;
+#endif
+}
+
+
+//========================================================================
+// Reports a focus change for the specified window
+//========================================================================
+
+static void reportFocus(_GLFWwindow* window, GLboolean focused)
+{
+    if (_glfw.events)
+    {
+        GLFWevent* event = _glfwPushEvent(window, GLFW_WINDOW_FOCUS_EVENT);
+        if (event)
+            event->data.state = focused;
     }
+    else if (window->callbacks.focus)
+        window->callbacks.focus((GLFWwindow*) window, focused);
 }
 
 
@@ -70,14 +111,15 @@ static void clearScrollOffsets(void)
 
 void _glfwInputWindowFocus(_GLFWwindow* window, GLboolean focused)
 {
+    if (!_glfwRecordInput(window, GLFW_WINDOW_FOCUS_EVENT, focused, 0))
+        return;
+
     if (focused)
     {
         if (_glfw.focusedWindow != window)
         {
             _glfw.focusedWindow = window;
-
-            if (window->callbacks.focus)
-                window->callbacks.focus((GLFWwindow*) window, focused);
+            reportFocus(window, focused);
         }
     }
     else
@@ -85,61 +127,106 @@ void _glfwInputWindowFocus(_GLFWwindow* window, GLboolean focused)
         if (_glfw.focusedWindow == window)
         {
             int i;
+            GLFWuint64 bits;
+            const GLboolean injecting = window->injecting;
+
+            // These releases are synthesized and so are not recorded
+            window->injecting = GL_TRUE;
 
             // Release all pressed keyboard keys
-            for (i = 0;  i <= GLFW_KEY_LAST;  i++)
+            for (i = 0;  i < GLFW_KEY_STATE_WORDS;  i++)
             {
-                if (window->key[i] == GLFW_PRESS)
-                    _glfwInputKey(window, i, GLFW_RELEASE);
+                bits = window->keys[i];
+                while (bits)
+                {
+                    _glfwInputKey(window,
+                                  i * 64 + findLowestBit(bits),
+                                  GLFW_RELEASE);
+                    bits &= bits - 1;
+                }
             }
 
             // Release all pressed mouse buttons
-            for (i = 0;  i <= GLFW_MOUSE_BUTTON_LAST;  i++)
+            bits = window->mouseButtons;
+            while (bits)
             {
-                if (window->mouseButton[i] == GLFW_PRESS)
-                    _glfwInputMouseClick(window, i, GLFW_RELEASE);
+                _glfwInputMouseClick(window, findLowestBit(bits), GLFW_RELEASE);
+                bits &= bits - 1;
             }
 
-            _glfw.focusedWindow = NULL;
+            window->injecting = injecting;
 
-            if (window->callbacks.focus)
-                window->callbacks.focus((GLFWwindow*) window, focused);
+            _glfw.focusedWindow = NULL;
+            reportFocus(window, focused);
         }
     }
 }
 
 void _glfwInputWindowPos(_GLFWwindow* window, int x, int y)
 {
+    if (!_glfwRecordInput(window, GLFW_WINDOW_POS_EVENT, x, y))
+        return;
+
     if (window->positionX == x && window->positionY == y)
         return;
 
     window->positionX = x;
     window->positionY = y;
 
-    if (window->callbacks.pos)
+    if (_glfw.events)
+    {
+        GLFWevent* event = _glfwPushEvent(window, GLFW_WINDOW_POS_EVENT);
+        if (event)
+        {
+            event->data.pos.x = x;
+            event->data.pos.y = y;
+        }
+    }
+    else if (window->callbacks.pos)
         window->callbacks.pos((GLFWwindow*) window, x, y);
 }
 
 void _glfwInputWindowSize(_GLFWwindow* window, int width, int height)
 {
+    if (!_glfwRecordInput(window, GLFW_WINDOW_SIZE_EVENT, width, height))
+        return;
+
     if (window->width == width && window->height == height)
         return;
 
     window->width = width;
     window->height = height;
 
-    if (window->callbacks.size)
+    if (_glfw.events)
+    {
+        GLFWevent* event = _glfwPushEvent(window, GLFW_WINDOW_SIZE_EVENT);
+        if (event)
+        {
+            event->data.size.width = width;
+            event->data.size.height = height;
+        }
+    }
+    else if (window->callbacks.size)
         window->callbacks.size((GLFWwindow*) window, width, height);
 }
 
 void _glfwInputWindowIconify(_GLFWwindow* window, int iconified)
 {
+    if (!_glfwRecordInput(window, GLFW_WINDOW_ICONIFY_EVENT, iconified, 0))
+        return;
+
     if (window->iconified == iconified)
         return;
 
     window->iconified = iconified;
 
-    if (window->callbacks.iconify)
+    if (_glfw.events)
+    {
+        GLFWevent* event = _glfwPushEvent(window, GLFW_WINDOW_ICONIFY_EVENT);
+        if (event)
+            event->data.state = iconified;
+    }
+    else if (window->callbacks.iconify)
         window->callbacks.iconify((GLFWwindow*) window, iconified);
 }
 
@@ -150,13 +237,28 @@ void _glfwInputWindowVisibility(_GLFWwindow* window, int visible)
 
 void _glfwInputWindowDamage(_GLFWwindow* window)
 {
-    if (window->callbacks.refresh)
+    if (!_glfwRecordInput(window, GLFW_WINDOW_REFRESH_EVENT, 0, 0))
+        return;
+
+    if (_glfw.events)
+        _glfwPushEvent(window, GLFW_WINDOW_REFRESH_EVENT);
+    else if (window->callbacks.refresh)
         window->callbacks.refresh((GLFWwindow*) window);
 }
 
 void _glfwInputWindowCloseRequest(_GLFWwindow* window)
 {
-    if (window->callbacks.close)
+    if (!_glfwRecordInput(window, GLFW_WINDOW_CLOSE_EVENT, 0, 0))
+        return;
+
+    if (_glfw.events)
+    {
+        // There is no callback to veto the request, so it is accepted and
+        // the application is informed of it through the queue
+        _glfwPushEvent(window, GLFW_WINDOW_CLOSE_EVENT);
+        window->closed = GL_TRUE;
+    }
+    else if (window->callbacks.close)
         window->closed = window->callbacks.close((GLFWwindow*) window);
     else
         window->closed = GL_TRUE;
@@ -211,6 +313,7 @@ GLFWAPI GLFWwindow* glfwCreateWindow(int width, int height,
     wndconfig.visible       = _glfw.hints.visible ? GL_TRUE : GL_FALSE;
     wndconfig.positionX     = _glfw.hints.positionX;
     wndconfig.positionY     = _glfw.hints.positionY;
+    wndconfig.refreshRate   = Max(_glfw.hints.refreshRate, 0);
     wndconfig.clientAPI     = _glfw.hints.clientAPI;
     wndconfig.glMajor       = _glfw.hints.glMajor;
     wndconfig.glMinor       = _glfw.hints.glMinor;
@@ -233,6 +336,8 @@ GLFWAPI GLFWwindow* glfwCreateWindow(int width, int height,
     }
 
     window->next = _glfw.windowListHead;
+    if (window->next)
+        window->next->prev = window;
     _glfw.windowListHead = window;
 
     // Remember window settings
@@ -244,11 +349,12 @@ GLFWAPI GLFWwindow* glfwCreateWindow(int width, int height,
     {
         window->resizable = GL_TRUE;
 
-        window->videoMode.width     = width;
-        window->videoMode.height    = height;
-        window->videoMode.redBits   = fbconfig.redBits;
-        window->videoMode.greenBits = fbconfig.greenBits;
-        window->videoMode.blueBits  = fbconfig.blueBits;
+        window->videoMode.width       = width;
+        window->videoMode.height      = height;
+        window->videoMode.redBits     = fbconfig.redBits;
+        window->videoMode.greenBits   = fbconfig.greenBits;
+        window->videoMode.blueBits    = fbconfig.blueBits;
+        window->videoMode.refreshRate = wndconfig.refreshRate;
     }
     else
         window->resizable = wndconfig.resizable;
@@ -390,6 +496,9 @@ GLFWAPI void glfwWindowHint(int target, int hint)
         case GLFW_POSITION_Y:
             _glfw.hints.positionY = hint;
             break;
+        case GLFW_REFRESH_RATE:
+            _glfw.hints.refreshRate = hint;
+            break;
         case GLFW_SAMPLES:
             _glfw.hints.samples = hint;
             break;
@@ -451,15 +560,20 @@ GLFWAPI void glfwDestroyWindow(GLFWwindow* handle)
 
     _glfwPlatformDestroyWindow(window);
 
-    // Unlink window from global linked list
-    {
-        _GLFWwindow** prev = &_glfw.windowListHead;
+    _glfwStopRecording(window);
 
-        while (*prev != window)
-            prev = &((*prev)->next);
+    // Remove any queued events that refer to the window
+    if (_glfw.events)
+        _glfwRemoveEvents(window);
 
-        *prev = window->next;
-    }
+    // Unlink window from global linked list
+    if (window->prev)
+        window->prev->next = window->next;
+    else
+        _glfw.windowListHead = window->next;
+
+    if (window->next)
+        window->next->prev = window->prev;
 
     free(window);
 }
@@ -615,6 +729,8 @@ GLFWAPI int glfwGetWindowParam(GLFWwindow* handle, int param)
             return window->glMinor;
         case GLFW_CONTEXT_REVISION:
             return window->glRevision;
+        case GLFW_REPLAYING:
+            return window->replay.records != NULL;
         case GLFW_CONTEXT_ROBUSTNESS:
             return window->glRobustness;
         case GLFW_OPENGL_FORWARD_COMPAT:
@@ -754,21 +870,69 @@ GLFWAPI void glfwPollEvents(void)
         return;
     }
 
-    clearScrollOffsets();
+    clearPollState();
 
     _glfwPlatformPollEvents();
+    _glfwPollReplay();
 }
 
 GLFWAPI void glfwWaitEvents(void)
 {
+    double timeout;
+
     if (!_glfwInitialized)
     {
         _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
         return;
     }
 
-    clearScrollOffsets();
+    clearPollState();
+
+    // Wake up in time to deliver any replayed input
+    timeout = _glfwGetReplayTimeout();
+    if (timeout < 0.0)
+        _glfwPlatformWaitEvents();
+    else
+        _glfwPlatformWaitEventsTimeout(timeout);
+
+    _glfwPollReplay();
+}
+
+GLFWAPI void glfwWaitEventsTimeout(double timeout)
+{
+    double replayTimeout;
+
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    if (timeout != timeout || timeout < 0.0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid timeout");
+        return;
+    }
+
+    clearPollState();
+
+    // Wake up in time to deliver any replayed input
+    replayTimeout = _glfwGetReplayTimeout();
+    if (replayTimeout >= 0.0 && replayTimeout < timeout)
+        timeout = replayTimeout;
+
+    _glfwPlatformWaitEventsTimeout(timeout);
+    _glfwPollReplay();
+}
+
+GLFWAPI void glfwPostEmptyEvent(void)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwInputError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
 
-    _glfwPlatformWaitEvents();
+    _glfwPlatformPostEmptyEvent();
 }
 
@@ -53,19 +53,20 @@ void _glfwInitGammaRamp(void)
         // This is reasonable as I suspect the that if they did differ, it
         // would imply that setting the gamma size to an arbitary size is
         // possible as well.
-        XRRScreenResources* rr = XRRGetScreenResources(_glfw.x11.display,
-                                                       _glfw.x11.root);
+        XRRScreenResources* rr = _glfwGetScreenResources();
+
+        if (rr && rr->ncrtc)
+        {
+            _glfw.originalRampSize = XRRGetCrtcGammaSize(_glfw.x11.display,
+                                                         rr->crtcs[0]);
+        }
 
-        _glfw.originalRampSize = XRRGetCrtcGammaSize(_glfw.x11.display,
-                                                     rr->crtcs[0]);
         if (_glfw.originalRampSize == 0)
         {
             // This is probably older Nvidia RandR with broken gamma support
             // Flag it as useless and try Xf86VidMode below, if available
             _glfw.x11.randr.gammaBroken = GL_TRUE;
         }
-
-        XRRFreeScreenResources(rr);
     }
 
     if (_glfw.x11.vidmode.available && !_glfw.originalRampSize)
@@ -114,12 +115,13 @@ void _glfwPlatformGetGammaRamp(GLFWgammaramp* ramp)
     if (_glfw.x11.randr.available && !_glfw.x11.randr.gammaBroken)
     {
         size_t size = GLFW_GAMMA_RAMP_SIZE * sizeof(unsigned short);
+        XRRCrtcGamma* gamma;
 
-        XRRScreenResources* rr = XRRGetScreenResources(_glfw.x11.display,
-                                                       _glfw.x11.root);
+        XRRScreenResources* rr = _glfwGetScreenResources();
+        if (!rr || !rr->ncrtc)
+            return;
 
-        XRRCrtcGamma* gamma = XRRGetCrtcGamma(_glfw.x11.display,
-                                              rr->crtcs[0]);
+        gamma = XRRGetCrtcGamma(_glfw.x11.display, rr->crtcs[0]);
 
         // TODO: Handle case of original ramp size having a size other than 256
 
@@ -128,7 +130,6 @@ void _glfwPlatformGetGammaRamp(GLFWgammaramp* ramp)
         memcpy(ramp->blue, gamma->blue, size);
 
         XRRFreeGamma(gamma);
-        XRRFreeScreenResources(rr);
     }
     else if (_glfw.x11.vidmode.available)
     {
@@ -157,8 +158,9 @@ void _glfwPlatformSetGammaRamp(const GLFWgammaramp* ramp)
         int i;
         size_t size = GLFW_GAMMA_RAMP_SIZE * sizeof(unsigned short);
 
-        XRRScreenResources* rr = XRRGetScreenResources(_glfw.x11.display,
-                                                       _glfw.x11.root);
+        XRRScreenResources* rr = _glfwGetScreenResources();
+        if (!rr)
+            return;
 
         // Update gamma per monitor
         for (i = 0;  i < rr->ncrtc;  i++)
@@ -172,8 +174,6 @@ void _glfwPlatformSetGammaRamp(const GLFWgammaramp* ramp)
             XRRSetCrtcGamma(_glfw.x11.display, rr->crtcs[i], gamma);
             XRRFreeGamma(gamma);
         }
-
-        XRRFreeScreenResources(rr);
     }
     else if (_glfw.x11.vidmode.available)
     {
@@ -34,6 +34,9 @@
 #include <string.h>
 #include <limits.h>
 
+// The number of slots in the XKB key name hash table
+#define _GLFW_KEY_NAME_SLOTS 128
+
 
 //========================================================================
 // Translate an X11 key code to a GLFW key code.
@@ -216,105 +219,117 @@ static int keyCodeToGLFWKeyCode(int keyCode)
 
 
 //========================================================================
-// Update the key code LUT
+// Hash an XKB key name, which is not necessarily null terminated
 //========================================================================
 
-static void updateKeyCodeLUT(void)
+static unsigned int hashKeyName(const char* name)
 {
-    int i, keyCode, keyCodeGLFW;
-    char name[XkbKeyNameLength + 1];
-    XkbDescPtr descr;
+    int i;
+    unsigned int hash = 0;
 
-    // Clear the LUT
-    for (keyCode = 0;  keyCode < 256;  keyCode++)
-        _glfw.x11.keyCodeLUT[keyCode] = -1;
+    for (i = 0;  i < XkbKeyNameLength;  i++)
+        hash = hash * 31 + (unsigned char) name[i];
+
+    return hash % _GLFW_KEY_NAME_SLOTS;
+}
 
-    // Use XKB to determine physical key locations independently of the current
-    // keyboard layout
 
-    // Get keyboard description
-    descr = XkbGetKeyboard(_glfw.x11.display,
-                            XkbAllComponentsMask,
-                            XkbUseCoreKbd);
+//========================================================================
+// Translate an XKB key name to a GLFW key code
+//========================================================================
 
-    // Find the X11 key code -> GLFW key code mapping
-    for (keyCode = descr->min_key_code; keyCode <= descr->max_key_code; ++keyCode)
+static int translateKeyName(const char* name)
+{
+    // The printable keys are mapped by physical location using the US
+    // keyboard layout, the rest of the keys (function keys) are mapped
+    // using traditional KeySym translations
+    static const struct
     {
-        // Get the key name
-        for (i = 0;  i < XkbKeyNameLength;  i++)
-            name[i] = descr->names->keys[keyCode].name[i];
-
-        name[XkbKeyNameLength] = 0;
-
-        // Map the key name to a GLFW key code. Note: We only map printable
-        // keys here, and we use the US keyboard layout. The rest of the
-        // keys (function keys) are mapped using traditional KeySym
-        // translations.
-        if (strcmp(name, "TLDE") == 0) keyCodeGLFW = GLFW_KEY_GRAVE_ACCENT;
-        else if (strcmp(name, "AE01") == 0) keyCodeGLFW = GLFW_KEY_1;
-        else if (strcmp(name, "AE02") == 0) keyCodeGLFW = GLFW_KEY_2;
-        else if (strcmp(name, "AE03") == 0) keyCodeGLFW = GLFW_KEY_3;
-        else if (strcmp(name, "AE04") == 0) keyCodeGLFW = GLFW_KEY_4;
-        else if (strcmp(name, "AE05") == 0) keyCodeGLFW = GLFW_KEY_5;
-        else if (strcmp(name, "AE06") == 0) keyCodeGLFW = GLFW_KEY_6;
-        else if (strcmp(name, "AE07") == 0) keyCodeGLFW = GLFW_KEY_7;
-        else if (strcmp(name, "AE08") == 0) keyCodeGLFW = GLFW_KEY_8;
-        else if (strcmp(name, "AE09") == 0) keyCodeGLFW = GLFW_KEY_9;
-        else if (strcmp(name, "AE10") == 0) keyCodeGLFW = GLFW_KEY_0;
-        else if (strcmp(name, "AE11") == 0) keyCodeGLFW = GLFW_KEY_MINUS;
-        else if (strcmp(name, "AE12") == 0) keyCodeGLFW = GLFW_KEY_EQUAL;
-        else if (strcmp(name, "AD01") == 0) keyCodeGLFW = GLFW_KEY_Q;
-        else if (strcmp(name, "AD02") == 0) keyCodeGLFW = GLFW_KEY_W;
-        else if (strcmp(name, "AD03") == 0) keyCodeGLFW = GLFW_KEY_E;
-        else if (strcmp(name, "AD04") == 0) keyCodeGLFW = GLFW_KEY_R;
-        else if (strcmp(name, "AD05") == 0) keyCodeGLFW = GLFW_KEY_T;
-        else if (strcmp(name, "AD06") == 0) keyCodeGLFW = GLFW_KEY_Y;
-        else if (strcmp(name, "AD07") == 0) keyCodeGLFW = GLFW_KEY_U;
-        else if (strcmp(name, "AD08") == 0) keyCodeGLFW = GLFW_KEY_I;
-        else if (strcmp(name, "AD09") == 0) keyCodeGLFW = GLFW_KEY_O;
-        else if (strcmp(name, "AD10") == 0) keyCodeGLFW = GLFW_KEY_P;
-        else if (strcmp(name, "AD11") == 0) keyCodeGLFW = GLFW_KEY_LEFT_BRACKET;
-        else if (strcmp(name, "AD12") == 0) keyCodeGLFW = GLFW_KEY_RIGHT_BRACKET;
-        else if (strcmp(name, "AC01") == 0) keyCodeGLFW = GLFW_KEY_A;
-        else if (strcmp(name, "AC02") == 0) keyCodeGLFW = GLFW_KEY_S;
-        else if (strcmp(name, "AC03") == 0) keyCodeGLFW = GLFW_KEY_D;
-        else if (strcmp(name, "AC04") == 0) keyCodeGLFW = GLFW_KEY_F;
-        else if (strcmp(name, "AC05") == 0) keyCodeGLFW = GLFW_KEY_G;
-        else if (strcmp(name, "AC06") == 0) keyCodeGLFW = GLFW_KEY_H;
-        else if (strcmp(name, "AC07") == 0) keyCodeGLFW = GLFW_KEY_J;
-        else if (strcmp(name, "AC08") == 0) keyCodeGLFW = GLFW_KEY_K;
-        else if (strcmp(name, "AC09") == 0) keyCodeGLFW = GLFW_KEY_L;
-        else if (strcmp(name, "AC10") == 0) keyCodeGLFW = GLFW_KEY_SEMICOLON;
-        else if (strcmp(name, "AC11") == 0) keyCodeGLFW = GLFW_KEY_APOSTROPHE;
-        else if (strcmp(name, "AB01") == 0) keyCodeGLFW = GLFW_KEY_Z;
-        else if (strcmp(name, "AB02") == 0) keyCodeGLFW = GLFW_KEY_X;
-        else if (strcmp(name, "AB03") == 0) keyCodeGLFW = GLFW_KEY_C;
-        else if (strcmp(name, "AB04") == 0) keyCodeGLFW = GLFW_KEY_V;
-        else if (strcmp(name, "AB05") == 0) keyCodeGLFW = GLFW_KEY_B;
-        else if (strcmp(name, "AB06") == 0) keyCodeGLFW = GLFW_KEY_N;
-        else if (strcmp(name, "AB07") == 0) keyCodeGLFW = GLFW_KEY_M;
-        else if (strcmp(name, "AB08") == 0) keyCodeGLFW = GLFW_KEY_COMMA;
-        else if (strcmp(name, "AB09") == 0) keyCodeGLFW = GLFW_KEY_PERIOD;
-        else if (strcmp(name, "AB10") == 0) keyCodeGLFW = GLFW_KEY_SLASH;
-        else if (strcmp(name, "BKSL") == 0) keyCodeGLFW = GLFW_KEY_BACKSLASH;
-        else if (strcmp(name, "LSGT") == 0) keyCodeGLFW = GLFW_KEY_WORLD_1;
-        else keyCodeGLFW = -1;
-
-        // Update the key code LUT
-        if ((keyCode >= 0) && (keyCode < 256))
-            _glfw.x11.keyCodeLUT[keyCode] = keyCodeGLFW;
-    }
+        char name[XkbKeyNameLength + 1];
+        int key;
+    } keyNames[] =
+    {
+        { "TLDE", GLFW_KEY_GRAVE_ACCENT },
+        { "AE01", GLFW_KEY_1 },
+        { "AE02", GLFW_KEY_2 },
+        { "AE03", GLFW_KEY_3 },
+        { "AE04", GLFW_KEY_4 },
+        { "AE05", GLFW_KEY_5 },
+        { "AE06", GLFW_KEY_6 },
+        { "AE07", GLFW_KEY_7 },
+        { "AE08", GLFW_KEY_8 },
+        { "AE09", GLFW_KEY_9 },
+        { "AE10", GLFW_KEY_0 },
+        { "AE11", GLFW_KEY_MINUS },
+        { "AE12", GLFW_KEY_EQUAL },
+        { "AD01", GLFW_KEY_Q },
+        { "AD02", GLFW_KEY_W },
+        { "AD03", GLFW_KEY_E },
+        { "AD04", GLFW_KEY_R },
+        { "AD05", GLFW_KEY_T },
+        { "AD06", GLFW_KEY_Y },
+        { "AD07", GLFW_KEY_U },
+        { "AD08", GLFW_KEY_I },
+        { "AD09", GLFW_KEY_O },
+        { "AD10", GLFW_KEY_P },
+        { "AD11", GLFW_KEY_LEFT_BRACKET },
+        { "AD12", GLFW_KEY_RIGHT_BRACKET },
+        { "AC01", GLFW_KEY_A },
+        { "AC02", GLFW_KEY_S },
+        { "AC03", GLFW_KEY_D },
+        { "AC04", GLFW_KEY_F },
+        { "AC05", GLFW_KEY_G },
+        { "AC06", GLFW_KEY_H },
+        { "AC07", GLFW_KEY_J },
+        { "AC08", GLFW_KEY_K },
+        { "AC09", GLFW_KEY_L },
+        { "AC10", GLFW_KEY_SEMICOLON },
+        { "AC11", GLFW_KEY_APOSTROPHE },
+        { "AB01", GLFW_KEY_Z },
+        { "AB02", GLFW_KEY_X },
+        { "AB03", GLFW_KEY_C },
+        { "AB04", GLFW_KEY_V },
+        { "AB05", GLFW_KEY_B },
+        { "AB06", GLFW_KEY_N },
+        { "AB07", GLFW_KEY_M },
+        { "AB08", GLFW_KEY_COMMA },
+        { "AB09", GLFW_KEY_PERIOD },
+        { "AB10", GLFW_KEY_SLASH },
+        { "BKSL", GLFW_KEY_BACKSLASH },
+        { "LSGT", GLFW_KEY_WORLD_1 }
+    };
+
+    // Open addressed hash of the above table, holding index + 1 of each
+    // entry so that zero marks an empty slot
+    static unsigned char slots[_GLFW_KEY_NAME_SLOTS];
+    static GLboolean initialized = GL_FALSE;
+
+    int i;
+    unsigned int hash;
+
+    if (!initialized)
+    {
+        for (i = 0;  i < sizeof(keyNames) / sizeof(keyNames[0]);  i++)
+        {
+            hash = hashKeyName(keyNames[i].name);
+            while (slots[hash])
+                hash = (hash + 1) % _GLFW_KEY_NAME_SLOTS;
 
-    // Free the keyboard description
-    XkbFreeKeyboard(descr, 0, True);
+            slots[hash] = i + 1;
+        }
 
-    // Translate the un-translated key codes using traditional X11 KeySym
-    // lookups
-    for (keyCode = 0;  keyCode < 256;  keyCode++)
+        initialized = GL_TRUE;
+    }
+
+    for (hash = hashKeyName(name);  slots[hash];
+         hash = (hash + 1) % _GLFW_KEY_NAME_SLOTS)
     {
-        if (_glfw.x11.keyCodeLUT[keyCode] < 0)
-            _glfw.x11.keyCodeLUT[keyCode] = keyCodeToGLFWKeyCode(keyCode);
+        i = slots[hash] - 1;
+        if (strncmp(keyNames[i].name, name, XkbKeyNameLength) == 0)
+            return keyNames[i].key;
     }
+
+    return -1;
 }
 
 
@@ -449,6 +464,7 @@ static GLboolean initDisplay(void)
     // this choice and hope for the best
     _glfw.x11.screen = DefaultScreen(_glfw.x11.display);
     _glfw.x11.root = RootWindow(_glfw.x11.display, _glfw.x11.screen);
+    _glfw.x11.context = XUniqueContext();
 
     // Find or create window manager atoms
     _glfw.x11.WM_STATE = XInternAtom(_glfw.x11.display, "WM_STATE", False);
@@ -510,10 +526,24 @@ static GLboolean initDisplay(void)
         return GL_FALSE;
     }
 
+    // Track changes to the keyboard mapping, so the key code LUT can be
+    // updated without restarting
+    XkbSelectEvents(_glfw.x11.display, XkbUseCoreKbd,
+                    XkbMapNotifyMask | XkbNewKeyboardNotifyMask,
+                    XkbMapNotifyMask | XkbNewKeyboardNotifyMask);
+
     // Update the key code LUT
-    // FIXME: We should listen to XkbMapNotify events to track changes to
-    // the keyboard mapping.
-    updateKeyCodeLUT();
+    _glfwUpdateKeyCodeLUT(0, 255);
+
+    // Track changes to the screen configuration, so the cached RandR screen
+    // resources are only fetched again when they may have changed
+    if (_glfw.x11.randr.available)
+    {
+        XRRSelectInput(_glfw.x11.display, _glfw.x11.root,
+                       RRScreenChangeNotifyMask |
+                       RRCrtcChangeNotifyMask |
+                       RROutputChangeNotifyMask);
+    }
 
     // Detect whether an EWMH-conformant window manager is running
     detectEWMH();
@@ -589,12 +619,74 @@ static void terminateDisplay(void)
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+//////                       GLFW internal API                      //////
+//////////////////////////////////////////////////////////////////////////
+
+//========================================================================
+// Update the key code LUT for the specified range of key codes
+//========================================================================
+
+void _glfwUpdateKeyCodeLUT(int firstKeyCode, int lastKeyCode)
+{
+    int keyCode;
+    XkbDescPtr descr;
+
+    if (firstKeyCode < 0)
+        firstKeyCode = 0;
+    if (lastKeyCode > 255)
+        lastKeyCode = 255;
+
+    // Clear the range
+    for (keyCode = firstKeyCode;  keyCode <= lastKeyCode;  keyCode++)
+        _glfw.x11.keyCodeLUT[keyCode] = -1;
+
+    // Use XKB to determine physical key locations independently of the current
+    // keyboard layout, requesting only the key names, as the full keyboard
+    // description is a large transfer
+    descr = XkbGetMap(_glfw.x11.display, 0, XkbUseCoreKbd);
+    if (descr)
+    {
+        if (XkbGetNames(_glfw.x11.display, XkbKeyNamesMask, descr) == Success)
+        {
+            for (keyCode = firstKeyCode;  keyCode <= lastKeyCode;  keyCode++)
+            {
+                if (keyCode < descr->min_key_code ||
+                    keyCode > descr->max_key_code)
+                {
+                    continue;
+                }
+
+                _glfw.x11.keyCodeLUT[keyCode] =
+                    translateKeyName(descr->names->keys[keyCode].name);
+            }
+        }
+
+        // Free the keyboard description, including the key names
+        XkbFreeKeyboard(descr, 0, True);
+    }
+
+    // Translate the un-translated key codes using traditional X11 KeySym
+    // lookups
+    for (keyCode = firstKeyCode;  keyCode <= lastKeyCode;  keyCode++)
+    {
+        if (_glfw.x11.keyCodeLUT[keyCode] < 0)
+            _glfw.x11.keyCodeLUT[keyCode] = keyCodeToGLFWKeyCode(keyCode);
+    }
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW platform API                      //////
 //////////////////////////////////////////////////////////////////////////
 
 int _glfwPlatformInit(void)
 {
+    // Zero is a valid file descriptor, so mark the ones we own as unset
+    // before anything can fail and leave them to be cleaned up
+    _glfw.x11.emptyEventPipe[0] = _glfw.x11.emptyEventPipe[1] = -1;
+    _glfw.x11.inotify.fd = -1;
+
     XInitThreads();
 
     if (!initDisplay())
@@ -607,11 +699,18 @@ int _glfwPlatformInit(void)
 
     _glfw.x11.cursor = createNULLCursor();
 
-    if (!_glfwInitJoysticks())
+    _glfwInitKeySymTable();
+
+    if (!_glfwInitEmptyEventPipe())
         return GL_FALSE;
 
+    // The joystick code needs to know the clock of the timer, so that device
+    // event timestamps can be put on the same timebase
     _glfwInitTimer();
 
+    if (!_glfwInitJoysticks())
+        return GL_FALSE;
+
     return GL_TRUE;
 }
 
@@ -627,6 +726,10 @@ void _glfwPlatformTerminate(void)
 
     _glfwTerminateJoysticks();
 
+    _glfwTerminateEmptyEventPipe();
+
+    _glfwInvalidateScreenResources();
+
     _glfwTerminateContextAPI();
 
     terminateDisplay();
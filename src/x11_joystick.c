@@ -31,143 +31,1043 @@
 #include "internal.h"
 
 #ifdef __linux__
-#include <linux/joystick.h>
+#if defined(_GLFW_USE_EVDEV)
+ #include <linux/input.h>
+#else
+ #include <linux/joystick.h>
+#endif
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/inotify.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <limits.h>
 #include <errno.h>
-#include <regex.h>
 #include <dirent.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+// The directories that may contain joystick device nodes
+static const char* joystickDirs[] =
+{
+    "/dev/input",
+    "/dev"
+};
+
+// The environment variable naming a directory to use instead of the above
+#define _GLFW_JOYSTICK_DIR_VARIABLE "GLFW_JOYSTICK_DIR"
+
+// The number of axes and buttons of a joystick emulated by a FIFO
+#define _GLFW_EMULATED_AXES 32
+#define _GLFW_EMULATED_BUTTONS 32
+
+// The number of events read from a device at a time
+#define _GLFW_JOYSTICK_BATCH_SIZE 64
+
+#if defined(_GLFW_USE_EVDEV)
+ // The name prefix of joystick device nodes
+ #define _GLFW_JOYSTICK_PREFIX "event"
+
+ // The number of longs in an evdev bit array of the specified size
+ #define _GLFW_LONG_BITS (sizeof(unsigned long) * 8)
+ #define _GLFW_BIT_LONGS(count) (((count) + _GLFW_LONG_BITS - 1) / _GLFW_LONG_BITS)
+#else
+ // The name prefix of joystick device nodes
+ #define _GLFW_JOYSTICK_PREFIX "js"
+#endif
 #endif // __linux__
 
 
 //========================================================================
-// Attempt to open the specified joystick device
+// Copies the snapshot of a joystick without blocking, retrying if it was
+// written to during the copy
+// The axis and button counts are the array sizes on input, or ignored if
+// the array is NULL, and the number of elements copied on output
+//========================================================================
+
+static GLboolean readJoystickState(int joy,
+                                   float* axes, int* numAxes,
+                                   unsigned char* buttons, int* numButtons)
+{
+    int i, axisCount, buttonCount;
+    unsigned int sequence;
+    GLboolean present;
+
+    do
+    {
+        sequence = _glfw.x11.snapshot[joy].sequence;
+        __sync_synchronize();
+
+        present = _glfw.x11.snapshot[joy].present;
+        axisCount = _glfw.x11.snapshot[joy].numAxes;
+        buttonCount = _glfw.x11.snapshot[joy].numButtons;
+
+        if (axes)
+        {
+            if (axisCount > *numAxes)
+                axisCount = *numAxes;
+
+            for (i = 0;  i < axisCount;  i++)
+                axes[i] = _glfw.x11.snapshot[joy].axes[i];
+        }
+
+        if (buttons)
+        {
+            if (buttonCount > *numButtons)
+                buttonCount = *numButtons;
+
+            for (i = 0;  i < buttonCount;  i++)
+                buttons[i] = _glfw.x11.snapshot[joy].buttons[i];
+        }
+
+        __sync_synchronize();
+    }
+    while ((sequence & 1) || sequence != _glfw.x11.snapshot[joy].sequence);
+
+    if (numAxes)
+        *numAxes = axisCount;
+    if (numButtons)
+        *numButtons = buttonCount;
+
+    return present;
+}
+
+
+#ifdef __linux__
+
+//========================================================================
+// Copies the state of a joystick to its snapshot for the query functions
+// The caller must hold the joystick mutex, which serializes the writers
+//========================================================================
+
+static void publishJoystickState(int joy)
+{
+    int i;
+    int numAxes = _glfw.x11.joystick[joy].numAxes;
+    int numButtons = _glfw.x11.joystick[joy].numButtons;
+
+    if (numAxes > _GLFW_JOYSTICK_MAX_AXES)
+        numAxes = _GLFW_JOYSTICK_MAX_AXES;
+    if (numButtons > _GLFW_JOYSTICK_MAX_BUTTONS)
+        numButtons = _GLFW_JOYSTICK_MAX_BUTTONS;
+
+    if (!_glfw.x11.joystick[joy].present)
+        numAxes = numButtons = 0;
+
+    // An odd sequence number tells readers that a write is in progress
+    _glfw.x11.snapshot[joy].sequence++;
+    __sync_synchronize();
+
+    _glfw.x11.snapshot[joy].present = _glfw.x11.joystick[joy].present;
+    _glfw.x11.snapshot[joy].numAxes = numAxes;
+    _glfw.x11.snapshot[joy].numButtons = numButtons;
+
+    for (i = 0;  i < numAxes;  i++)
+        _glfw.x11.snapshot[joy].axes[i] = _glfw.x11.joystick[joy].axis[i];
+
+    for (i = 0;  i < numButtons;  i++)
+        _glfw.x11.snapshot[joy].buttons[i] = _glfw.x11.joystick[joy].button[i];
+
+    __sync_synchronize();
+    _glfw.x11.snapshot[joy].sequence++;
+}
+
+
+//========================================================================
+// Returns whether the specified device node name is that of a joystick
+//========================================================================
+
+static GLboolean isJoystickName(const char* name)
+{
+    const size_t length = strlen(_GLFW_JOYSTICK_PREFIX);
+
+    if (strncmp(name, _GLFW_JOYSTICK_PREFIX, length) != 0)
+        return GL_FALSE;
+
+    name += length;
+    if (*name == '\0')
+        return GL_FALSE;
+
+    for (;  *name;  name++)
+    {
+        if (*name < '0' || *name > '9')
+            return GL_FALSE;
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Returns whether the specified device is a FIFO emulating a joystick
+//========================================================================
+
+static GLboolean isEmulatedDevice(int fd)
+{
+    struct stat st;
+
+    if (fstat(fd, &st) != 0)
+        return GL_FALSE;
+
+    return S_ISFIFO(st.st_mode) ? GL_TRUE : GL_FALSE;
+}
+
+
+//========================================================================
+// Updates a joystick axis and records the change
+//========================================================================
+
+static void setJoystickAxis(int joy, int axis, float value, double time)
+{
+    if (_glfw.x11.joystick[joy].axis[axis] == value)
+        return;
+
+    _glfw.x11.joystick[joy].axis[axis] = value;
+
+    // The history belongs to the thread processing events
+    if (!_glfw.x11.joystickThread.running)
+        _glfwInputJoystickAxis(joy, axis, value, time);
+}
+
+
+//========================================================================
+// Updates a joystick button and records the change
+//========================================================================
+
+static void setJoystickButton(int joy, int button, int action, double time)
+{
+    if (_glfw.x11.joystick[joy].button[button] == action)
+        return;
+
+    _glfw.x11.joystick[joy].button[button] = (unsigned char) action;
+
+    // The history belongs to the thread processing events
+    if (!_glfw.x11.joystickThread.running)
+        _glfwInputJoystickButton(joy, button, action, time);
+}
+
+#if defined(_GLFW_USE_EVDEV)
+
+//========================================================================
+// Returns whether the specified bit is set in an evdev bit array
+//========================================================================
+
+static GLboolean isBitSet(int bit, const unsigned long* bits)
+{
+    return (bits[bit / _GLFW_LONG_BITS] >> (bit % _GLFW_LONG_BITS)) & 1;
+}
+
+
+//========================================================================
+// Sets the specified bit in an evdev bit array
+//========================================================================
+
+static void setBit(int bit, unsigned long* bits)
+{
+    bits[bit / _GLFW_LONG_BITS] |= 1UL << (bit % _GLFW_LONG_BITS);
+}
+
+
+//========================================================================
+// Converts an evdev event timestamp to the GLFW timebase
+//========================================================================
+
+static double getEventTime(int joy, const struct timeval* time)
+{
+    uint64_t raw;
+
+    if (_glfw.x11.joystick[joy].monotonic != _glfw.x11.timer.monotonic)
+    {
+        // The device is not using the clock of the GLFW timer
+        return _glfwPlatformGetTime();
+    }
+
+    if (_glfw.x11.timer.monotonic)
+    {
+        raw = (uint64_t) time->tv_sec * (uint64_t) 1000000000 +
+              (uint64_t) time->tv_usec * (uint64_t) 1000;
+    }
+    else
+        raw = (uint64_t) time->tv_sec * (uint64_t) 1000000 + (uint64_t) time->tv_usec;
+
+    return (double) (int64_t) (raw - _glfw.x11.timer.base) *
+        _glfw.x11.timer.resolution;
+}
+
+
+//========================================================================
+// Normalizes an evdev axis value to [-1,1] using the range of that axis
+//========================================================================
+
+static float normalizeAxis(int joy, int code, int value)
+{
+    float normalized;
+    const struct input_absinfo* info = _glfw.x11.joystick[joy].absInfo + code;
+
+    if (info->maximum <= info->minimum)
+        return 0.f;
+
+    if (info->flat)
+    {
+        // Values within the flat area around the center are reported as zero
+        const int center = info->minimum + (info->maximum - info->minimum) / 2;
+        if (abs(value - center) <= info->flat)
+            return 0.f;
+    }
+
+    normalized = 2.f * (value - info->minimum) /
+                 (float) (info->maximum - info->minimum) - 1.f;
+
+    // We need to change the sign for the Y axes, so that
+    // positive = up/forward, according to the GLFW spec.
+    if (code == ABS_Y || code == ABS_RY ||
+        (code >= ABS_HAT0X && code <= ABS_HAT3Y && ((code - ABS_HAT0X) & 1)))
+    {
+        normalized = -normalized;
+    }
+
+    return normalized;
+}
+
+
+//========================================================================
+// Reads the current state of every button and axis of a joystick
+//========================================================================
+
+static void syncJoystickState(int joy, GLboolean record)
+{
+    int code, index;
+    float value;
+    const int fd = _glfw.x11.joystick[joy].fd;
+    const double time = _glfwPlatformGetTime();
+    unsigned long keyBits[_GLFW_BIT_LONGS(KEY_CNT)];
+
+    memset(keyBits, 0, sizeof(keyBits));
+    ioctl(fd, EVIOCGKEY(sizeof(keyBits)), keyBits);
+
+    for (code = BTN_MISC;  code < KEY_CNT;  code++)
+    {
+        index = _glfw.x11.joystick[joy].buttonMap[code - BTN_MISC];
+        if (index == -1)
+            continue;
+
+        if (record)
+        {
+            setJoystickButton(joy, index,
+                              isBitSet(code, keyBits) ? GLFW_PRESS : GLFW_RELEASE,
+                              time);
+        }
+        else
+        {
+            _glfw.x11.joystick[joy].button[index] =
+                isBitSet(code, keyBits) ? GLFW_PRESS : GLFW_RELEASE;
+        }
+    }
+
+    for (code = 0;  code < ABS_CNT;  code++)
+    {
+        index = _glfw.x11.joystick[joy].axisMap[code];
+        if (index == -1)
+            continue;
+
+        if (ioctl(fd, EVIOCGABS(code), _glfw.x11.joystick[joy].absInfo + code) < 0)
+            continue;
+
+        value = normalizeAxis(joy, code, _glfw.x11.joystick[joy].absInfo[code].value);
+
+        if (record)
+            setJoystickAxis(joy, index, value, time);
+        else
+            _glfw.x11.joystick[joy].axis[index] = value;
+    }
+}
+
+
+//========================================================================
+// Queries the capabilities of an opened evdev joystick device
+//========================================================================
+
+static GLboolean initJoystickDevice(int joy, int fd)
+{
+    int code, numAxes = 0, numButtons = 0;
+    char name[256];
+    GLboolean joystickButtons = GL_FALSE;
+    const GLboolean emulated = isEmulatedDevice(fd);
+    unsigned long evBits[_GLFW_BIT_LONGS(EV_CNT)];
+    unsigned long keyBits[_GLFW_BIT_LONGS(KEY_CNT)];
+    unsigned long absBits[_GLFW_BIT_LONGS(ABS_CNT)];
+
+    memset(evBits, 0, sizeof(evBits));
+    memset(keyBits, 0, sizeof(keyBits));
+    memset(absBits, 0, sizeof(absBits));
+
+    if (emulated)
+    {
+        // A FIFO cannot be queried, so it gets the first absolute axes and
+        // joystick buttons, each with the range of the joystick API
+        setBit(EV_ABS, evBits);
+
+        for (code = 0;  code < _GLFW_EMULATED_AXES;  code++)
+            setBit(code, absBits);
+
+        for (code = 0;  code < _GLFW_EMULATED_BUTTONS;  code++)
+            setBit(BTN_JOYSTICK + code, keyBits);
+    }
+    else if (ioctl(fd, EVIOCGBIT(0, sizeof(evBits)), evBits) < 0 ||
+             ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) < 0 ||
+             ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits) < 0)
+    {
+        return GL_FALSE;
+    }
+
+    if (!isBitSet(EV_ABS, evBits))
+        return GL_FALSE;
+
+    // Touchpads and tablets also have absolute axes, so only devices with
+    // joystick or gamepad buttons are treated as joysticks
+    for (code = BTN_JOYSTICK;  code < BTN_DIGI;  code++)
+    {
+        if (isBitSet(code, keyBits))
+            joystickButtons = GL_TRUE;
+    }
+
+    for (code = BTN_TRIGGER_HAPPY;  code <= BTN_TRIGGER_HAPPY40;  code++)
+    {
+        if (isBitSet(code, keyBits))
+            joystickButtons = GL_TRUE;
+    }
+
+    if (!joystickButtons)
+        return GL_FALSE;
+
+    for (code = 0;  code < ABS_CNT;  code++)
+    {
+        _glfw.x11.joystick[joy].axisMap[code] = -1;
+
+        if (!isBitSet(code, absBits))
+            continue;
+
+        if (emulated)
+        {
+            memset(_glfw.x11.joystick[joy].absInfo + code, 0,
+                   sizeof(struct input_absinfo));
+            _glfw.x11.joystick[joy].absInfo[code].minimum = -32767;
+            _glfw.x11.joystick[joy].absInfo[code].maximum = 32767;
+        }
+        else if (ioctl(fd, EVIOCGABS(code), _glfw.x11.joystick[joy].absInfo + code) < 0)
+            continue;
+
+        _glfw.x11.joystick[joy].axisMap[code] = numAxes++;
+    }
+
+    for (code = BTN_MISC;  code < KEY_CNT;  code++)
+    {
+        _glfw.x11.joystick[joy].buttonMap[code - BTN_MISC] = -1;
+
+        if (isBitSet(code, keyBits))
+            _glfw.x11.joystick[joy].buttonMap[code - BTN_MISC] = numButtons++;
+    }
+
+    _glfw.x11.joystick[joy].numAxes = numAxes;
+    _glfw.x11.joystick[joy].numButtons = numButtons;
+
+    _glfw.x11.joystick[joy].axis = (float*) calloc(numAxes + 1, sizeof(float));
+    if (_glfw.x11.joystick[joy].axis == NULL)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return GL_FALSE;
+    }
+
+    _glfw.x11.joystick[joy].button = (unsigned char*) calloc(numButtons + 1, 1);
+    if (_glfw.x11.joystick[joy].button == NULL)
+    {
+        free(_glfw.x11.joystick[joy].axis);
+
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return GL_FALSE;
+    }
+
+    if (emulated)
+        strncpy(name, "Emulated joystick", sizeof(name));
+    else if (ioctl(fd, EVIOCGNAME(sizeof(name)), name) < 0)
+        strncpy(name, "Unknown", sizeof(name));
+
+    _glfw.x11.joystick[joy].name = strdup(name);
+
+    // Have the kernel timestamp events with the clock used by the timer, so
+    // they can be converted to the GLFW timebase
+    _glfw.x11.joystick[joy].monotonic = GL_FALSE;
+
+    if (emulated)
+    {
+        // The writer of a FIFO is expected to use the clock of the timer
+        _glfw.x11.joystick[joy].monotonic = _glfw.x11.timer.monotonic;
+    }
+#if defined(CLOCK_MONOTONIC) && defined(EVIOCSCLOCKID)
+    else if (_glfw.x11.timer.monotonic)
+    {
+        int clock = CLOCK_MONOTONIC;
+        if (ioctl(fd, EVIOCSCLOCKID, &clock) == 0)
+            _glfw.x11.joystick[joy].monotonic = GL_TRUE;
+    }
+#endif
+
+    if (!emulated)
+        syncJoystickState(joy, GL_FALSE);
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Processes the queued events of an evdev joystick device
+// Returns GL_FALSE if the device has been disconnected
+//========================================================================
+
+static GLboolean pollJoystickDevice(int joy)
+{
+    ssize_t i, count;
+    struct input_event events[_GLFW_JOYSTICK_BATCH_SIZE];
+
+    for (;;)
+    {
+        count = read(_glfw.x11.joystick[joy].fd, events, sizeof(events));
+        if (count == -1)
+            return errno != ENODEV;
+
+        // Only a FIFO has an end, reached when its writer closes it
+        if (count == 0)
+            return GL_FALSE;
+
+        count /= sizeof(struct input_event);
+        if (count == 0)
+            return GL_TRUE;
+
+        for (i = 0;  i < count;  i++)
+        {
+            const struct input_event* e = events + i;
+            const double time = getEventTime(joy, &e->time);
+            int index;
+
+            switch (e->type)
+            {
+                case EV_ABS:
+                    if (e->code >= ABS_CNT)
+                        break;
+
+                    index = _glfw.x11.joystick[joy].axisMap[e->code];
+                    if (index != -1)
+                    {
+                        setJoystickAxis(joy, index,
+                                        normalizeAxis(joy, e->code, e->value),
+                                        time);
+                    }
+
+                    break;
+
+                case EV_KEY:
+                    if (e->code < BTN_MISC || e->code >= KEY_CNT)
+                        break;
+
+                    index = _glfw.x11.joystick[joy].buttonMap[e->code - BTN_MISC];
+                    if (index != -1)
+                    {
+                        setJoystickButton(joy, index,
+                                          e->value ? GLFW_PRESS : GLFW_RELEASE,
+                                          time);
+                    }
+
+                    break;
+
+                case EV_SYN:
+                    // The kernel buffer overflowed and events were lost
+                    if (e->code == SYN_DROPPED)
+                        syncJoystickState(joy, GL_TRUE);
+
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        // A short read means the queue has been drained
+        if (count < _GLFW_JOYSTICK_BATCH_SIZE)
+            return GL_TRUE;
+    }
+}
+
+#else
+
+//========================================================================
+// Queries the capabilities of an opened joystick API device
+//========================================================================
+
+static GLboolean initJoystickDevice(int joy, int fd)
+{
+    char numAxes, numButtons;
+    char name[256];
+    int version;
+
+    if (isEmulatedDevice(fd))
+    {
+        // A FIFO cannot be queried, so it gets a fixed number of controls
+        strncpy(name, "Emulated joystick", sizeof(name));
+        numAxes = _GLFW_EMULATED_AXES;
+        numButtons = _GLFW_EMULATED_BUTTONS;
+    }
+    else
+    {
+        // Verify that the joystick driver version is at least 1.0
+        ioctl(fd, JSIOCGVERSION, &version);
+        if (version < 0x010000)
+        {
+            // It's an old 0.x interface (we don't support it)
+            return GL_FALSE;
+        }
+
+        if (ioctl(fd, JSIOCGNAME(sizeof(name)), name) < 0)
+            strncpy(name, "Unknown", sizeof(name));
+
+        ioctl(fd, JSIOCGAXES, &numAxes);
+        ioctl(fd, JSIOCGBUTTONS, &numButtons);
+    }
+
+    _glfw.x11.joystick[joy].numAxes = (int) numAxes;
+    _glfw.x11.joystick[joy].numButtons = (int) numButtons;
+
+    _glfw.x11.joystick[joy].axis = (float*) calloc(numAxes, sizeof(float));
+    if (_glfw.x11.joystick[joy].axis == NULL)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return GL_FALSE;
+    }
+
+    _glfw.x11.joystick[joy].button = (unsigned char*) calloc(numButtons, 1);
+    if (_glfw.x11.joystick[joy].button == NULL)
+    {
+        free(_glfw.x11.joystick[joy].axis);
+
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return GL_FALSE;
+    }
+
+    _glfw.x11.joystick[joy].name = strdup(name);
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Processes the queued events of a joystick API device
+// Returns GL_FALSE if the device has been disconnected
+//========================================================================
+
+static GLboolean pollJoystickDevice(int joy)
+{
+    ssize_t i, count;
+    double now;
+    struct js_event events[_GLFW_JOYSTICK_BATCH_SIZE];
+
+    // Read all queued events (non-blocking), as many as fit at a time, as a
+    // busy joystick can otherwise cost thousands of reads per frame
+    for (;;)
+    {
+        count = read(_glfw.x11.joystick[joy].fd, events, sizeof(events));
+        if (count == -1)
+            return errno != ENODEV;
+
+        // Only a FIFO has an end, reached when its writer closes it
+        if (count == 0)
+            return GL_FALSE;
+
+        count /= sizeof(struct js_event);
+        if (count == 0)
+            return GL_TRUE;
+
+        now = _glfwPlatformGetTime();
+
+        for (i = 0;  i < count;  i++)
+        {
+            struct js_event* e = events + i;
+            GLboolean record = GL_TRUE;
+            double time;
+            float value;
+
+            // The millisecond timestamps are on an unspecified clock, so the
+            // last event read is placed at the current time and the others
+            // relative to it
+            time = now - (int) (events[count - 1].time - e->time) / 1000.0;
+
+            // Init events report the initial state and are not changes
+            if (e->type & JS_EVENT_INIT)
+            {
+                e->type &= ~JS_EVENT_INIT;
+                record = GL_FALSE;
+            }
+
+            switch (e->type)
+            {
+                case JS_EVENT_AXIS:
+                    if (e->number >= _glfw.x11.joystick[joy].numAxes)
+                        break;
+
+                    value = (float) e->value / 32767.0f;
+
+                    // We need to change the sign for the Y axes, so that
+                    // positive = up/forward, according to the GLFW spec.
+                    if (e->number & 1)
+                        value = -value;
+
+                    if (record)
+                        setJoystickAxis(joy, e->number, value, time);
+                    else
+                        _glfw.x11.joystick[joy].axis[e->number] = value;
+
+                    break;
+
+                case JS_EVENT_BUTTON:
+                    if (e->number >= _glfw.x11.joystick[joy].numButtons)
+                        break;
+
+                    if (record)
+                    {
+                        setJoystickButton(joy, e->number,
+                                          e->value ? GLFW_PRESS : GLFW_RELEASE,
+                                          time);
+                    }
+                    else
+                    {
+                        _glfw.x11.joystick[joy].button[e->number] =
+                            e->value ? GLFW_PRESS : GLFW_RELEASE;
+                    }
+
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        // A short read means the queue has been drained
+        if (count < _GLFW_JOYSTICK_BATCH_SIZE)
+            return GL_TRUE;
+    }
+}
+
+#endif // _GLFW_USE_EVDEV
+
+
+//========================================================================
+// Makes the sampling thread, if any, rebuild its set of watched devices
 //========================================================================
 
-static int openJoystickDevice(int joy, const char* path)
+static void wakeJoystickThread(void)
 {
-#ifdef __linux__
-    char numAxes, numButtons;
-    char name[256];
-    int fd, version;
+    const char byte = 0;
 
-    fd = open(path, O_RDONLY | O_NONBLOCK);
-    if (fd == -1)
-        return GL_FALSE;
+    if (!_glfw.x11.joystickThread.running)
+        return;
+
+    // A full pipe already guarantees a wakeup, so a failed write is harmless
+    if (write(_glfw.x11.joystickThread.wakePipe[1], &byte, 1) < 0)
+        return;
+}
 
-    _glfw.x11.joystick[joy].fd = fd;
 
-    // Verify that the joystick driver version is at least 1.0
-    ioctl(fd, JSIOCGVERSION, &version);
-    if (version < 0x010000)
+//========================================================================
+// Entry point of the joystick sampling thread
+// It waits for input on the present joysticks, processes it as soon as it
+// arrives and publishes the new state, leaving connections and
+// disconnections to the event processing thread
+//========================================================================
+
+static void* joystickThreadMain(void* arg)
+{
+    for (;;)
     {
-        // It's an old 0.x interface (we don't support it)
-        close(fd);
-        return GL_FALSE;
+        int i, count = 1, joys[GLFW_JOYSTICK_LAST + 1];
+        struct pollfd fds[1 + GLFW_JOYSTICK_LAST + 1];
+        GLboolean lost = GL_FALSE;
+
+        fds[0].fd = _glfw.x11.joystickThread.wakePipe[0];
+        fds[0].events = POLLIN;
+
+        pthread_mutex_lock(&_glfw.x11.joystickThread.mutex);
+
+        if (_glfw.x11.joystickThread.stop)
+        {
+            pthread_mutex_unlock(&_glfw.x11.joystickThread.mutex);
+            break;
+        }
+
+        for (i = 0;  i <= GLFW_JOYSTICK_LAST;  i++)
+        {
+            if (!_glfw.x11.joystick[i].present || _glfw.x11.joystick[i].lost)
+                continue;
+
+            fds[count].fd = _glfw.x11.joystick[i].fd;
+            fds[count].events = POLLIN;
+            joys[count - 1] = i;
+            count++;
+        }
+
+        pthread_mutex_unlock(&_glfw.x11.joystickThread.mutex);
+
+        if (poll(fds, count, -1) == -1)
+            continue;
+
+        if (fds[0].revents & POLLIN)
+        {
+            char buffer[64];
+
+            while (read(fds[0].fd, buffer, sizeof(buffer)) > 0)
+                ;
+        }
+
+        pthread_mutex_lock(&_glfw.x11.joystickThread.mutex);
+
+        for (i = 1;  i < count;  i++)
+        {
+            const int joy = joys[i - 1];
+
+            if (!fds[i].revents)
+                continue;
+
+            // The device may have been closed while we were waiting
+            if (!_glfw.x11.joystick[joy].present ||
+                _glfw.x11.joystick[joy].fd != fds[i].fd)
+            {
+                continue;
+            }
+
+            if (pollJoystickDevice(joy))
+                publishJoystickState(joy);
+            else
+            {
+                _glfw.x11.joystick[joy].lost = GL_TRUE;
+                lost = GL_TRUE;
+            }
+        }
+
+        pthread_mutex_unlock(&_glfw.x11.joystickThread.mutex);
+
+        // Disconnections are reported by the thread processing events
+        if (lost)
+            _glfwPlatformPostEmptyEvent();
     }
 
-    if (ioctl(fd, JSIOCGNAME(sizeof(name)), name) < 0)
-        strncpy(name, "Unknown", sizeof(name));
+    return NULL;
+}
 
-    _glfw.x11.joystick[joy].name = strdup(name);
 
-    ioctl(fd, JSIOCGAXES, &numAxes);
-    _glfw.x11.joystick[joy].numAxes = (int) numAxes;
+//========================================================================
+// Stops the joystick sampling thread and waits for it to exit
+//========================================================================
 
-    ioctl(fd, JSIOCGBUTTONS, &numButtons);
-    _glfw.x11.joystick[joy].numButtons = (int) numButtons;
+static void stopJoystickThread(void)
+{
+    if (!_glfw.x11.joystickThread.running)
+        return;
 
-    _glfw.x11.joystick[joy].axis = (float*) malloc(sizeof(float) * numAxes);
-    if (_glfw.x11.joystick[joy].axis == NULL)
+    pthread_mutex_lock(&_glfw.x11.joystickThread.mutex);
+    _glfw.x11.joystickThread.stop = GL_TRUE;
+    pthread_mutex_unlock(&_glfw.x11.joystickThread.mutex);
+
+    wakeJoystickThread();
+    pthread_join(_glfw.x11.joystickThread.handle, NULL);
+
+    close(_glfw.x11.joystickThread.wakePipe[0]);
+    close(_glfw.x11.joystickThread.wakePipe[1]);
+
+    _glfw.x11.joystickThread.running = GL_FALSE;
+}
+
+
+//========================================================================
+// Attempt to open the specified joystick device in a free slot
+// Returns the joystick the device was assigned, or -1 if it was not opened
+//========================================================================
+
+static int openJoystickDevice(const char* path)
+{
+    int joy, fd;
+
+    for (joy = 0;  joy <= GLFW_JOYSTICK_LAST;  joy++)
     {
-        close(fd);
+        if (_glfw.x11.joystick[joy].present &&
+            strcmp(_glfw.x11.joystick[joy].path, path) == 0)
+        {
+            // This device is already open
+            return -1;
+        }
+    }
 
-        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
-        return GL_FALSE;
+    for (joy = 0;  joy <= GLFW_JOYSTICK_LAST;  joy++)
+    {
+        if (!_glfw.x11.joystick[joy].present)
+            break;
     }
 
-    _glfw.x11.joystick[joy].button = (unsigned char*) malloc(numButtons);
-    if (_glfw.x11.joystick[joy].button == NULL)
+    if (joy > GLFW_JOYSTICK_LAST)
+        return -1;
+
+    fd = open(path, O_RDONLY | O_NONBLOCK);
+    if (fd == -1)
+        return -1;
+
+    _glfw.x11.joystick[joy].fd = fd;
+
+    if (!initJoystickDevice(joy, fd))
     {
-        free(_glfw.x11.joystick[joy].axis);
         close(fd);
-
-        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
-        return GL_FALSE;
+        return -1;
     }
 
+    _glfw.x11.joystick[joy].path = strdup(path);
+
+    pthread_mutex_lock(&_glfw.x11.joystickThread.mutex);
     _glfw.x11.joystick[joy].present = GL_TRUE;
-#endif // __linux__
+    publishJoystickState(joy);
+    pthread_mutex_unlock(&_glfw.x11.joystickThread.mutex);
 
-    return GL_TRUE;
+    wakeJoystickThread();
+    return joy;
 }
 
 
 //========================================================================
-// Polls for and processes events for all present joysticks
+// Close the specified joystick device and free its slot
 //========================================================================
 
-static void pollJoystickEvents(void)
+static void closeJoystickDevice(int joy)
 {
-#ifdef __linux__
-    int i;
-    ssize_t result;
-    struct js_event e;
+    pthread_mutex_lock(&_glfw.x11.joystickThread.mutex);
 
-    for (i = 0;  i <= GLFW_JOYSTICK_LAST;  i++)
+    close(_glfw.x11.joystick[joy].fd);
+    free(_glfw.x11.joystick[joy].axis);
+    free(_glfw.x11.joystick[joy].button);
+    free(_glfw.x11.joystick[joy].name);
+    free(_glfw.x11.joystick[joy].path);
+
+    memset(&_glfw.x11.joystick[joy], 0, sizeof(_glfw.x11.joystick[joy]));
+    publishJoystickState(joy);
+
+    pthread_mutex_unlock(&_glfw.x11.joystickThread.mutex);
+
+    wakeJoystickThread();
+}
+
+
+//========================================================================
+// Open any joystick device in the specified directory not already opened
+//========================================================================
+
+static void scanJoystickDirectory(const char* dirname, GLboolean report)
+{
+    DIR* dir;
+    struct dirent* entry;
+
+    dir = opendir(dirname);
+    if (!dir)
+        return;
+
+    while ((entry = readdir(dir)))
     {
-        if (!_glfw.x11.joystick[i].present)
+        int joy;
+        char path[PATH_MAX];
+
+        if (!isJoystickName(entry->d_name))
             continue;
 
-        // Read all queued events (non-blocking)
-        for (;;)
-        {
-            errno = 0;
-            result = read(_glfw.x11.joystick[i].fd, &e, sizeof(e));
+        snprintf(path, sizeof(path), "%s/%s", dirname, entry->d_name);
+
+        joy = openJoystickDevice(path);
+        if (joy != -1 && report)
+            _glfwInputJoystickChange(joy, GLFW_CONNECTED);
+    }
+
+    closedir(dir);
+}
+
+
+//========================================================================
+// Process pending joystick device node creation and removal
+//========================================================================
+
+static void pollJoystickHotplug(void)
+{
+    ssize_t size, offset;
+    char buffer[4096];
+    struct inotify_event event;
 
-            if (errno == ENODEV)
-                _glfw.x11.joystick[i].present = GL_FALSE;
+    if (_glfw.x11.inotify.fd == -1)
+        return;
 
-            if (result == -1)
-                break;
+    while ((size = read(_glfw.x11.inotify.fd, buffer, sizeof(buffer))) > 0)
+    {
+        for (offset = 0;  offset < size;
+             offset += sizeof(struct inotify_event) + event.len)
+        {
+            int i, joy;
+            char path[PATH_MAX];
+            const char* name = buffer + offset + sizeof(struct inotify_event);
 
-            // We don't care if it's an init event or not
-            e.type &= ~JS_EVENT_INIT;
+            // The buffer is not necessarily aligned for the event struct
+            memcpy(&event, buffer + offset, sizeof(struct inotify_event));
 
-            switch (e.type)
+            if (event.mask & IN_Q_OVERFLOW)
             {
-                case JS_EVENT_AXIS:
-                    _glfw.x11.joystick[i].axis[e.number] =
-                        (float) e.value / 32767.0f;
+                // Events were lost, so find any joysticks that were missed
+                for (i = 0;  i < _glfw.x11.joystickDirCount;  i++)
+                    scanJoystickDirectory(_glfw.x11.joystickDirs[i], GL_TRUE);
 
-                    // We need to change the sign for the Y axes, so that
-                    // positive = up/forward, according to the GLFW spec.
-                    if (e.number & 1)
-                    {
-                        _glfw.x11.joystick[i].axis[e.number] =
-                            -_glfw.x11.joystick[i].axis[e.number];
-                    }
+                continue;
+            }
 
+            for (i = 0;  i < _glfw.x11.joystickDirCount;  i++)
+            {
+                if (event.wd == _glfw.x11.inotify.watches[i])
                     break;
+            }
 
-                case JS_EVENT_BUTTON:
-                    _glfw.x11.joystick[i].button[e.number] =
-                        e.value ? GLFW_PRESS : GLFW_RELEASE;
-                    break;
+            if (i == _glfw.x11.joystickDirCount ||
+                !event.len || !isJoystickName(name))
+            {
+                continue;
+            }
 
-                default:
-                    break;
+            snprintf(path, sizeof(path), "%s/%s", _glfw.x11.joystickDirs[i], name);
+
+            if (event.mask & (IN_CREATE | IN_ATTRIB | IN_MOVED_TO))
+            {
+                // A node may not be readable when it is created, so opening
+                // is attempted again when its permissions change
+                joy = openJoystickDevice(path);
+                if (joy != -1)
+                    _glfwInputJoystickChange(joy, GLFW_CONNECTED);
+            }
+            else if (event.mask & (IN_DELETE | IN_MOVED_FROM))
+            {
+                for (joy = 0;  joy <= GLFW_JOYSTICK_LAST;  joy++)
+                {
+                    if (_glfw.x11.joystick[joy].present &&
+                        strcmp(_glfw.x11.joystick[joy].path, path) == 0)
+                    {
+                        closeJoystickDevice(joy);
+                        _glfwInputJoystickChange(joy, GLFW_DISCONNECTED);
+                        break;
+                    }
+                }
             }
         }
     }
-#endif // __linux__
 }
 
+#endif // __linux__
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW internal API                      //////
@@ -180,46 +1080,44 @@ static void pollJoystickEvents(void)
 int _glfwInitJoysticks(void)
 {
 #ifdef __linux__
-    int i, joy = 0;
-    regex_t regex;
-    DIR* dir;
-    const char* dirs[] =
-    {
-        "/dev/input",
-        "/dev"
-    };
+    int i;
+    const char* dir;
+
+    pthread_mutex_init(&_glfw.x11.joystickThread.mutex, NULL);
+    _glfw.x11.joysticksInitialized = GL_TRUE;
 
-    if (regcomp(&regex, "^js[0-9]\\+$", 0) != 0)
+    // Test harnesses may provide a directory of FIFOs to stand in for the
+    // device nodes
+    dir = getenv(_GLFW_JOYSTICK_DIR_VARIABLE);
+    if (dir && *dir)
     {
-        _glfwInputError(GLFW_PLATFORM_ERROR, "X11: Failed to compile regex");
-        return GL_FALSE;
+        _glfw.x11.joystickDirs[0] = strdup(dir);
+        _glfw.x11.joystickDirCount = 1;
     }
-
-    for (i = 0;  i < sizeof(dirs) / sizeof(dirs[0]);  i++)
+    else
     {
-        struct dirent* entry;
+        for (i = 0;  i < sizeof(joystickDirs) / sizeof(joystickDirs[0]);  i++)
+            _glfw.x11.joystickDirs[i] = strdup(joystickDirs[i]);
 
-        dir = opendir(dirs[i]);
-        if (!dir)
-            continue;
+        _glfw.x11.joystickDirCount = i;
+    }
 
-        while ((entry = readdir(dir)))
+    // Joysticks connected later are detected by watching for their device
+    // nodes, so the watches are added before the initial scan
+    _glfw.x11.inotify.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_glfw.x11.inotify.fd != -1)
+    {
+        for (i = 0;  i < _glfw.x11.joystickDirCount;  i++)
         {
-            char path[20];
-            regmatch_t match;
-
-            if (regexec(&regex, entry->d_name, 1, &match, 0) != 0)
-                continue;
-
-            snprintf(path, sizeof(path), "%s/%s", dirs[i], entry->d_name);
-            if (openJoystickDevice(joy, path))
-                joy++;
+            _glfw.x11.inotify.watches[i] =
+                inotify_add_watch(_glfw.x11.inotify.fd, _glfw.x11.joystickDirs[i],
+                                  IN_CREATE | IN_ATTRIB | IN_DELETE |
+                                  IN_MOVED_TO | IN_MOVED_FROM);
         }
-
-        closedir(dir);
     }
 
-    regfree(&regex);
+    for (i = 0;  i < _glfw.x11.joystickDirCount;  i++)
+        scanJoystickDirectory(_glfw.x11.joystickDirs[i], GL_FALSE);
 #endif // __linux__
 
     return GL_TRUE;
@@ -235,17 +1133,68 @@ void _glfwTerminateJoysticks(void)
 #ifdef __linux__
     int i;
 
+    // Platform initialization may have failed before reaching the joysticks
+    if (!_glfw.x11.joysticksInitialized)
+        return;
+
+    stopJoystickThread();
+
     for (i = 0;  i <= GLFW_JOYSTICK_LAST;  i++)
     {
         if (_glfw.x11.joystick[i].present)
+            closeJoystickDevice(i);
+    }
+
+    if (_glfw.x11.inotify.fd != -1)
+    {
+        close(_glfw.x11.inotify.fd);
+        _glfw.x11.inotify.fd = -1;
+    }
+
+    for (i = 0;  i < _glfw.x11.joystickDirCount;  i++)
+        free(_glfw.x11.joystickDirs[i]);
+
+    _glfw.x11.joystickDirCount = 0;
+
+    pthread_mutex_destroy(&_glfw.x11.joystickThread.mutex);
+    _glfw.x11.joysticksInitialized = GL_FALSE;
+#endif // __linux__
+}
+
+
+//========================================================================
+// Polls for and processes events for all present joysticks
+//========================================================================
+
+void _glfwPollJoystickEvents(void)
+{
+#ifdef __linux__
+    int i;
+
+    pollJoystickHotplug();
+
+    for (i = 0;  i <= GLFW_JOYSTICK_LAST;  i++)
+    {
+        if (!_glfw.x11.joystick[i].present)
+            continue;
+
+        if (_glfw.x11.joystickThread.running)
         {
-            close(_glfw.x11.joystick[i].fd);
-            free(_glfw.x11.joystick[i].axis);
-            free(_glfw.x11.joystick[i].button);
-            free(_glfw.x11.joystick[i].name);
+            GLboolean lost;
 
-            _glfw.x11.joystick[i].present = GL_FALSE;
+            // The sampling thread reads the device and only flags its loss
+            pthread_mutex_lock(&_glfw.x11.joystickThread.mutex);
+            lost = _glfw.x11.joystick[i].lost;
+            pthread_mutex_unlock(&_glfw.x11.joystickThread.mutex);
+
+            if (!lost)
+                continue;
         }
+        else if (pollJoystickDevice(i))
+            continue;
+
+        closeJoystickDevice(i);
+        _glfwInputJoystickChange(i, GLFW_DISCONNECTED);
     }
 #endif // __linux__
 }
@@ -257,10 +1206,24 @@ void _glfwTerminateJoysticks(void)
 
 int _glfwPlatformGetJoystickParam(int joy, int param)
 {
-    pollJoystickEvents();
+    int numAxes, numButtons;
 
-    if (!_glfw.x11.joystick[joy].present)
-        return 0;
+    if (_glfw.joystickPolling == GLFW_POLL_ON_THREAD)
+    {
+        if (!readJoystickState(joy, NULL, &numAxes, NULL, &numButtons))
+            return 0;
+    }
+    else
+    {
+        if (_glfw.joystickPolling == GLFW_POLL_ON_QUERY)
+            _glfwPollJoystickEvents();
+
+        if (!_glfw.x11.joystick[joy].present)
+            return 0;
+
+        numAxes = _glfw.x11.joystick[joy].numAxes;
+        numButtons = _glfw.x11.joystick[joy].numButtons;
+    }
 
     switch (param)
     {
@@ -268,10 +1231,10 @@ int _glfwPlatformGetJoystickParam(int joy, int param)
             return GL_TRUE;
 
         case GLFW_AXES:
-            return _glfw.x11.joystick[joy].numAxes;
+            return numAxes;
 
         case GLFW_BUTTONS:
-            return _glfw.x11.joystick[joy].numButtons;
+            return numButtons;
 
         default:
             _glfwInputError(GLFW_INVALID_ENUM, NULL);
@@ -284,7 +1247,14 @@ int _glfwPlatformGetJoystickAxes(int joy, float* axes, int numAxes)
 {
     int i;
 
-    pollJoystickEvents();
+    if (_glfw.joystickPolling == GLFW_POLL_ON_THREAD)
+    {
+        readJoystickState(joy, axes, &numAxes, NULL, NULL);
+        return numAxes;
+    }
+
+    if (_glfw.joystickPolling == GLFW_POLL_ON_QUERY)
+        _glfwPollJoystickEvents();
 
     if (!_glfw.x11.joystick[joy].present)
         return 0;
@@ -303,7 +1273,14 @@ int _glfwPlatformGetJoystickButtons(int joy, unsigned char* buttons,
 {
     int i;
 
-    pollJoystickEvents();
+    if (_glfw.joystickPolling == GLFW_POLL_ON_THREAD)
+    {
+        readJoystickState(joy, NULL, NULL, buttons, &numButtons);
+        return numButtons;
+    }
+
+    if (_glfw.joystickPolling == GLFW_POLL_ON_QUERY)
+        _glfwPollJoystickEvents();
 
     if (!_glfw.x11.joystick[joy].present)
         return 0;
@@ -317,6 +1294,70 @@ int _glfwPlatformGetJoystickButtons(int joy, unsigned char* buttons,
     return numButtons;
 }
 
+int _glfwPlatformSetJoystickPolling(int mode)
+{
+#ifdef __linux__
+    int i, joy;
+
+    if (mode != GLFW_POLL_ON_THREAD)
+    {
+        stopJoystickThread();
+        return GL_TRUE;
+    }
+
+    if (pipe(_glfw.x11.joystickThread.wakePipe) != 0)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Failed to create joystick thread wake pipe");
+        return GL_FALSE;
+    }
+
+    for (i = 0;  i < 2;  i++)
+    {
+        const int sf = fcntl(_glfw.x11.joystickThread.wakePipe[i], F_GETFL, 0);
+        const int df = fcntl(_glfw.x11.joystickThread.wakePipe[i], F_GETFD, 0);
+
+        fcntl(_glfw.x11.joystickThread.wakePipe[i], F_SETFL, sf | O_NONBLOCK);
+        fcntl(_glfw.x11.joystickThread.wakePipe[i], F_SETFD, df | FD_CLOEXEC);
+    }
+
+    // The query functions switch to the snapshots as soon as this returns,
+    // so they must be current before the thread starts updating them
+    pthread_mutex_lock(&_glfw.x11.joystickThread.mutex);
+
+    for (joy = 0;  joy <= GLFW_JOYSTICK_LAST;  joy++)
+        publishJoystickState(joy);
+
+    _glfw.x11.joystickThread.stop = GL_FALSE;
+    _glfw.x11.joystickThread.running = GL_TRUE;
+
+    pthread_mutex_unlock(&_glfw.x11.joystickThread.mutex);
+
+    if (pthread_create(&_glfw.x11.joystickThread.handle, NULL,
+                       joystickThreadMain, NULL) != 0)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Failed to create joystick thread");
+
+        _glfw.x11.joystickThread.running = GL_FALSE;
+        close(_glfw.x11.joystickThread.wakePipe[0]);
+        close(_glfw.x11.joystickThread.wakePipe[1]);
+        return GL_FALSE;
+    }
+
+    return GL_TRUE;
+#else
+    if (mode == GLFW_POLL_ON_THREAD)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Joystick polling on a thread is not supported");
+        return GL_FALSE;
+    }
+
+    return GL_TRUE;
+#endif // __linux__
+}
+
 const char* _glfwPlatformGetJoystickName(int joy)
 {
     if (!_glfw.x11.joystick[joy].present)
@@ -30,104 +30,430 @@
 
 #include "internal.h"
 
-#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
 
+//========================================================================
+// Returns the mode info for the specified RandR mode
+//========================================================================
+
+static const XRRModeInfo* getModeInfo(const XRRScreenResources* sr, RRMode id)
+{
+    int i;
+
+    for (i = 0;  i < sr->nmode;  i++)
+    {
+        if (sr->modes[i].id == id)
+            return sr->modes + i;
+    }
+
+    return NULL;
+}
+
+
+//========================================================================
+// Calculates the refresh rate, in Hz, from the specified RandR mode info
+//========================================================================
+
+static int calculateRefreshRate(const XRRModeInfo* mi)
+{
+    double vTotal = mi->vTotal;
+
+    if (!mi->hTotal || !mi->vTotal)
+        return 0;
+
+    // Interlaced modes scan half of the lines per field and double scan
+    // modes scan every line twice
+    if (mi->modeFlags & RR_Interlace)
+        vTotal /= 2.0;
+    if (mi->modeFlags & RR_DoubleScan)
+        vTotal *= 2.0;
+
+    return (int) ((double) mi->dotClock / ((double) mi->hTotal * vTotal) + 0.5);
+}
+
+
+//========================================================================
+// Caches the current video mode of the specified monitor, with the color
+// bits left to be filled in when it is queried
+//========================================================================
+
+static void setCurrentMode(_GLFWmonitor* monitor,
+                           const XRRModeInfo* mi,
+                           Rotation rotation)
+{
+    GLFWvidmode* mode = &monitor->x11.currentMode;
+
+    memset(mode, 0, sizeof(GLFWvidmode));
+
+    // A disabled crtc has no mode
+    if (!mi)
+        return;
+
+    if (rotation & (RR_Rotate_90 | RR_Rotate_270))
+    {
+        mode->width = mi->height;
+        mode->height = mi->width;
+    }
+    else
+    {
+        mode->width = mi->width;
+        mode->height = mi->height;
+    }
+
+    mode->refreshRate = calculateRefreshRate(mi);
+}
+
+
+//========================================================================
+// Caches the current video mode of all monitors using the specified crtc
+//========================================================================
+
+static void setCrtcMode(RRCrtc crtc, const XRRModeInfo* mi, Rotation rotation)
+{
+    int i;
+
+    for (i = 0;  i < _glfw.monitorCount;  i++)
+    {
+        if (_glfw.monitors[i]->x11.crtc == crtc)
+            setCurrentMode(_glfw.monitors[i], mi, rotation);
+    }
+}
+
+
+//========================================================================
+// Updates the crtc of the specified monitor along with its position and
+// current video mode
+//========================================================================
+
+static void setMonitorCrtc(_GLFWmonitor* monitor,
+                           XRRScreenResources* sr,
+                           RRCrtc crtc)
+{
+    XRRCrtcInfo* ci;
+
+    monitor->x11.crtc = crtc;
+    monitor->positionX = 0;
+    monitor->positionY = 0;
+    setCurrentMode(monitor, NULL, RR_Rotate_0);
+
+    // A connected output may be disabled, in which case it has no crtc,
+    // and querying it would cause an X error
+    if (crtc == None)
+        return;
+
+    ci = XRRGetCrtcInfo(_glfw.x11.display, sr, crtc);
+    if (!ci)
+        return;
+
+    monitor->positionX = ci->x;
+    monitor->positionY = ci->y;
+    setCurrentMode(monitor, getModeInfo(sr, ci->mode), ci->rotation);
+
+    XRRFreeCrtcInfo(ci);
+}
+
+
+//========================================================================
+// Creates a monitor for the specified connected output
+//========================================================================
+
+static _GLFWmonitor* createMonitor(XRRScreenResources* sr,
+                                   RROutput output,
+                                   const XRROutputInfo* oi,
+                                   RROutput primary)
+{
+    _GLFWmonitor* monitor;
+
+    monitor = _glfwCreateMonitor(oi->name,
+                                 output == primary,
+                                 oi->mm_width, oi->mm_height,
+                                 0, 0);
+    if (!monitor)
+        return NULL;
+
+    monitor->x11.output = output;
+    setMonitorCrtc(monitor, sr, oi->crtc);
+
+    return monitor;
+}
+
+
+//========================================================================
+// Returns the monitor of the specified output, if it is connected
+//========================================================================
+
+static _GLFWmonitor* findMonitor(RROutput output)
+{
+    int i;
+
+    for (i = 0;  i < _glfw.monitorCount;  i++)
+    {
+        if (_glfw.monitors[i]->x11.output == output)
+            return _glfw.monitors[i];
+    }
+
+    return NULL;
+}
+
+
+//========================================================================
+// Returns the current size of the screen
+//========================================================================
+
+static void getScreenSize(int* width, int* height)
+{
+    Window root;
+    int x, y;
+    unsigned int rootWidth, rootHeight, border, depth;
+
+    // The size cached by Xlib is only updated once the notification of
+    // a change has been processed, but the root window always covers the
+    // whole screen
+    XGetGeometry(_glfw.x11.display, _glfw.x11.root,
+                 &root, &x, &y,
+                 &rootWidth, &rootHeight,
+                 &border, &depth);
+
+    *width = rootWidth;
+    *height = rootHeight;
+}
+
+
+//========================================================================
+// Grows the screen to contain the specified area, remembering its original
+// size the first time it is changed
+//========================================================================
+
+static GLboolean growScreen(int width, int height)
+{
+    int currentWidth, currentHeight;
+    int minWidth, minHeight, maxWidth, maxHeight;
+
+    getScreenSize(&currentWidth, &currentHeight);
+
+    if (width <= currentWidth && height <= currentHeight)
+        return GL_TRUE;
+
+    if (width < currentWidth)
+        width = currentWidth;
+    if (height < currentHeight)
+        height = currentHeight;
+
+    if (!XRRGetScreenSizeRange(_glfw.x11.display, _glfw.x11.root,
+                               &minWidth, &minHeight,
+                               &maxWidth, &maxHeight))
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Failed to retrieve RandR screen size range");
+        return GL_FALSE;
+    }
+
+    if (width > maxWidth || height > maxHeight)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Video mode does not fit within the largest "
+                        "possible screen");
+        return GL_FALSE;
+    }
+
+    if (!_glfw.x11.randr.screenChanged)
+    {
+        _glfw.x11.randr.oldWidth = currentWidth;
+        _glfw.x11.randr.oldHeight = currentHeight;
+        _glfw.x11.randr.oldWidthMM =
+            DisplayWidthMM(_glfw.x11.display, _glfw.x11.screen);
+        _glfw.x11.randr.oldHeightMM =
+            DisplayHeightMM(_glfw.x11.display, _glfw.x11.screen);
+        _glfw.x11.randr.screenChanged = GL_TRUE;
+    }
+
+    // The physical size is scaled along with the screen to keep its DPI
+    XRRSetScreenSize(_glfw.x11.display, _glfw.x11.root,
+                     width, height,
+                     _glfw.x11.randr.oldWidthMM * width /
+                         _glfw.x11.randr.oldWidth,
+                     _glfw.x11.randr.oldHeightMM * height /
+                         _glfw.x11.randr.oldHeight);
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Shrinks the screen back to its original size once no monitor is left
+// in a changed video mode
+//========================================================================
+
+static void restoreScreenSize(void)
+{
+    int i;
+
+    if (!_glfw.x11.randr.screenChanged)
+        return;
+
+    for (i = 0;  i < _glfw.monitorCount;  i++)
+    {
+        if (_glfw.monitors[i]->x11.oldMode != None)
+            return;
+    }
+
+    XRRSetScreenSize(_glfw.x11.display, _glfw.x11.root,
+                     _glfw.x11.randr.oldWidth,
+                     _glfw.x11.randr.oldHeight,
+                     _glfw.x11.randr.oldWidthMM,
+                     _glfw.x11.randr.oldHeightMM);
+
+    _glfw.x11.randr.screenChanged = GL_FALSE;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW internal API                      //////
 //////////////////////////////////////////////////////////////////////////
 
 //========================================================================
-// Finds the video mode closest in size to the specified desired size
+// Returns the RandR screen resources, retrieving them if necessary
 //========================================================================
 
-int _glfwGetClosestVideoMode(_GLFWmonitor* monitor, int* width, int* height)
+XRRScreenResources* _glfwGetScreenResources(void)
 {
-    int i, match, bestmatch;
+    if (!_glfw.x11.randr.resources)
+    {
+        // Unlike XRRGetScreenResources, this does not make the server probe
+        // the outputs, which can take a long time with some drivers
+        _glfw.x11.randr.resources =
+            XRRGetScreenResourcesCurrent(_glfw.x11.display, _glfw.x11.root);
+        if (!_glfw.x11.randr.resources)
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Failed to retrieve RandR screen resources");
+        }
+    }
 
-    if (_glfw.x11.randr.available)
+    return _glfw.x11.randr.resources;
+}
+
+
+//========================================================================
+// Discards the cached RandR screen resources
+//========================================================================
+
+void _glfwInvalidateScreenResources(void)
+{
+    if (_glfw.x11.randr.resources)
     {
-        int sizecount, bestsize;
-        XRRScreenConfiguration* sc;
-        XRRScreenSize* sizelist;
+        XRRFreeScreenResources(_glfw.x11.randr.resources);
+        _glfw.x11.randr.resources = NULL;
+    }
+}
 
-        sc = XRRGetScreenInfo(_glfw.x11.display, _glfw.x11.root);
 
-        sizelist = XRRConfigSizes(sc, &sizecount);
+//========================================================================
+// Updates the monitor of the specified output after a change to it,
+// creating or destroying it if the output was connected or disconnected
+//========================================================================
 
-        // Find the best matching mode
-        bestsize  = -1;
-        bestmatch = INT_MAX;
-        for (i = 0;  i < sizecount;  i++)
+void _glfwUpdateOutput(RROutput output)
+{
+    int i;
+    XRRScreenResources* sr;
+    XRROutputInfo* oi = NULL;
+    _GLFWmonitor* monitor = findMonitor(output);
+
+    sr = _glfwGetScreenResources();
+    if (!sr)
+        return;
+
+    // The output itself may be gone, for example with USB display adapters,
+    // and querying it would then cause an X error
+    for (i = 0;  i < sr->noutput;  i++)
+    {
+        if (sr->outputs[i] == output)
         {
-            match = (*width - sizelist[i].width) *
-                    (*width - sizelist[i].width) +
-                    (*height - sizelist[i].height) *
-                    (*height - sizelist[i].height);
-            if (match < bestmatch)
-            {
-                bestmatch = match;
-                bestsize  = i;
-            }
+            oi = XRRGetOutputInfo(_glfw.x11.display, sr, output);
+            break;
         }
+    }
 
-        if (bestsize != -1)
+    if (oi && oi->connection == RR_Connected)
+    {
+        if (monitor)
         {
-            // Report width & height of best matching mode
-            *width = sizelist[bestsize].width;
-            *height = sizelist[bestsize].height;
-        }
+            monitor->widthMM = oi->mm_width;
+            monitor->heightMM = oi->mm_height;
+            setMonitorCrtc(monitor, sr, oi->crtc);
 
-        XRRFreeScreenConfigInfo(sc);
+            // The modes of the output may have changed along with its crtc
+            _glfwInvalidateVideoModes(monitor);
+        }
+        else
+        {
+            RROutput primary = XRRGetOutputPrimary(_glfw.x11.display,
+                                                   _glfw.x11.root);
 
-        if (bestsize != -1)
-            return bestsize;
+            monitor = createMonitor(sr, output, oi, primary);
+            if (monitor)
+                _glfwInputMonitorConnect(monitor);
+        }
     }
+    else if (monitor)
+        _glfwInputMonitorDisconnect(monitor);
 
-    // Default: Simply use the screen resolution
-    *width = DisplayWidth(_glfw.x11.display, _glfw.x11.screen);
-    *height = DisplayHeight(_glfw.x11.display, _glfw.x11.screen);
-
-    return 0;
+    if (oi)
+        XRRFreeOutputInfo(oi);
 }
 
 
 //========================================================================
-// Change the current video mode
+// Updates the position and current video mode of the monitors using the
+// specified crtc
 //========================================================================
 
-void _glfwSetVideoModeMODE(_GLFWmonitor* monitor, int mode)
+void _glfwUpdateCrtc(RRCrtc crtc, RRMode mode, Rotation rotation, int x, int y)
 {
-    if (_glfw.x11.randr.available)
+    int i;
+    const XRRModeInfo* mi = NULL;
+
+    for (i = 0;  i < _glfw.monitorCount;  i++)
     {
-        XRRScreenConfiguration* sc;
-        Window root;
+        _GLFWmonitor* monitor = _glfw.monitors[i];
 
-        root = _glfw.x11.root;
-        sc   = XRRGetScreenInfo(_glfw.x11.display, root);
+        if (monitor->x11.crtc != crtc)
+            continue;
 
-        // Remember old size and flag that we have changed the mode
-        if (!monitor->x11.modeChanged)
+        // The refresh rate is only known from the mode info, which is
+        // retrieved once for all monitors of the crtc
+        if (mode != None && !mi)
         {
-            monitor->x11.oldSizeID = XRRConfigCurrentConfiguration(sc, &monitor->x11.oldRotation);
-            monitor->x11.oldWidth  = DisplayWidth(_glfw.x11.display,
-                                                  _glfw.x11.screen);
-            monitor->x11.oldHeight = DisplayHeight(_glfw.x11.display,
-                                                   _glfw.x11.screen);
-
-            monitor->x11.modeChanged = GL_TRUE;
+            XRRScreenResources* sr = _glfwGetScreenResources();
+            if (sr)
+                mi = getModeInfo(sr, mode);
         }
 
-        XRRSetScreenConfig(_glfw.x11.display,
-                           sc,
-                           root,
-                           mode,
-                           RR_Rotate_0,
-                           CurrentTime);
+        monitor->positionX = x;
+        monitor->positionY = y;
+        setCurrentMode(monitor, mi, rotation);
+    }
+}
+
+
+//========================================================================
+// Updates which monitor is the primary one
+//========================================================================
 
-        XRRFreeScreenConfigInfo(sc);
+void _glfwUpdatePrimaryMonitor(void)
+{
+    int i;
+    RROutput primary;
+
+    primary = XRRGetOutputPrimary(_glfw.x11.display, _glfw.x11.root);
+
+    for (i = 0;  i < _glfw.monitorCount;  i++)
+    {
+        _GLFWmonitor* monitor = _glfw.monitors[i];
+        monitor->primary = (monitor->x11.output == primary);
     }
 }
 
@@ -136,15 +462,144 @@ void _glfwSetVideoModeMODE(_GLFWmonitor* monitor, int mode)
 // Change the current video mode
 //========================================================================
 
-void _glfwSetVideoMode(_GLFWmonitor* monitor, int* width, int* height)
+int _glfwSetVideoMode(_GLFWmonitor* monitor, const GLFWvidmode* desired)
 {
-    int bestmode;
+    if (_glfw.x11.randr.available)
+    {
+        int i, width, height;
+        Status status;
+        GLboolean first;
+        RRMode native = None;
+        const XRRModeInfo* nativeInfo = NULL;
+        XRRScreenResources* sr;
+        XRROutputInfo* oi;
+        XRRCrtcInfo* ci;
+        const GLFWvidmode* best;
+
+        best = _glfwChooseVideoMode(monitor, desired);
+        if (!best)
+            return GL_FALSE;
+
+        if (monitor->x11.crtc == None)
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Monitor has no active RandR crtc");
+            return GL_FALSE;
+        }
+
+        sr = _glfwGetScreenResources();
+        if (!sr)
+            return GL_FALSE;
+
+        oi = XRRGetOutputInfo(_glfw.x11.display, sr, monitor->x11.output);
+        ci = XRRGetCrtcInfo(_glfw.x11.display, sr, monitor->x11.crtc);
+        if (!oi || !ci)
+        {
+            if (oi)
+                XRRFreeOutputInfo(oi);
+            if (ci)
+                XRRFreeCrtcInfo(ci);
+
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Failed to retrieve RandR monitor info");
+            return GL_FALSE;
+        }
+
+        for (i = 0;  i < oi->nmode;  i++)
+        {
+            const XRRModeInfo* mi = getModeInfo(sr, oi->modes[i]);
+            if (!mi)
+                continue;
+
+            if (mi->width == best->width &&
+                mi->height == best->height &&
+                calculateRefreshRate(mi) == best->refreshRate)
+            {
+                native = mi->id;
+                nativeInfo = mi;
+                break;
+            }
+        }
+
+        XRRFreeOutputInfo(oi);
+
+        if (native == None)
+        {
+            XRRFreeCrtcInfo(ci);
+
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Failed to find RandR mode of video mode");
+            return GL_FALSE;
+        }
+
+        if (ci->mode == native)
+        {
+            XRRFreeCrtcInfo(ci);
+            return GL_TRUE;
+        }
+
+        if (ci->rotation & (RR_Rotate_90 | RR_Rotate_270))
+        {
+            width = best->height;
+            height = best->width;
+        }
+        else
+        {
+            width = best->width;
+            height = best->height;
+        }
+
+        // The crtc keeps its position, so the screen may need to grow for
+        // the new mode to fit within it
+        if (!growScreen(ci->x + width, ci->y + height))
+        {
+            XRRFreeCrtcInfo(ci);
+            return GL_FALSE;
+        }
+
+        // Remember the original crtc and its mode, but only the first time
+        first = (monitor->x11.oldMode == None);
+        if (first)
+        {
+            monitor->x11.oldCrtc = monitor->x11.crtc;
+            monitor->x11.oldMode = ci->mode;
+        }
+
+        status = XRRSetCrtcConfig(_glfw.x11.display,
+                                  sr, monitor->x11.crtc,
+                                  CurrentTime,
+                                  ci->x, ci->y,
+                                  native,
+                                  ci->rotation,
+                                  ci->outputs,
+                                  ci->noutput);
+
+        // The notification of the change may arrive much later, but the new
+        // mode is expected to be reported as soon as this returns
+        if (status == Success)
+            setCrtcMode(monitor->x11.crtc, nativeInfo, ci->rotation);
+
+        XRRFreeCrtcInfo(ci);
 
-    // Find a best match mode
-    bestmode = _glfwGetClosestVideoMode(monitor, width, height);
+        // Do not wait for the notification to stop using the old resources
+        _glfwInvalidateScreenResources();
 
-    // Change mode
-    _glfwSetVideoModeMODE(monitor, bestmode);
+        if (status != Success)
+        {
+            // Nothing was changed if this was the first attempt
+            if (first)
+            {
+                monitor->x11.oldMode = None;
+                restoreScreenSize();
+            }
+
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Failed to set RandR crtc config");
+            return GL_FALSE;
+        }
+    }
+
+    return GL_TRUE;
 }
 
 
@@ -154,26 +609,62 @@ void _glfwSetVideoMode(_GLFWmonitor* monitor, int* width, int* height)
 
 void _glfwRestoreVideoMode(_GLFWmonitor* monitor)
 {
-    if (!monitor->x11.modeChanged)
+    if (monitor->x11.oldMode == None)
         return;
 
     if (_glfw.x11.randr.available)
     {
-        XRRScreenConfiguration* sc;
+        Status status;
+        XRRScreenResources* sr;
+        XRRCrtcInfo* ci;
 
-        sc = XRRGetScreenInfo(_glfw.x11.display, _glfw.x11.root);
+        sr = _glfwGetScreenResources();
+        if (!sr)
+            return;
 
-        XRRSetScreenConfig(_glfw.x11.display,
-                           sc,
-                           _glfw.x11.root,
-                           monitor->x11.oldSizeID,
-                           monitor->x11.oldRotation,
-                           CurrentTime);
+        // The monitor may have been moved to another crtc since its mode
+        // was changed, but it is the original crtc that needs restoring
+        ci = XRRGetCrtcInfo(_glfw.x11.display, sr, monitor->x11.oldCrtc);
+        if (!ci)
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Failed to retrieve RandR crtc info");
+            return;
+        }
 
-        XRRFreeScreenConfigInfo(sc);
-    }
+        // Only the mode was changed, so the rest of the crtc config is kept
+        status = XRRSetCrtcConfig(_glfw.x11.display,
+                                  sr, monitor->x11.oldCrtc,
+                                  CurrentTime,
+                                  ci->x, ci->y,
+                                  monitor->x11.oldMode,
+                                  ci->rotation,
+                                  ci->outputs,
+                                  ci->noutput);
+
+        if (status == Success)
+        {
+            setCrtcMode(monitor->x11.oldCrtc,
+                        getModeInfo(sr, monitor->x11.oldMode),
+                        ci->rotation);
+        }
+
+        XRRFreeCrtcInfo(ci);
+
+        // Do not wait for the notification to stop using the old resources
+        _glfwInvalidateScreenResources();
 
-    monitor->x11.modeChanged = GL_FALSE;
+        monitor->x11.oldMode = None;
+
+        // The screen can only shrink once the crtc fits within it again
+        if (status == Success)
+            restoreScreenSize();
+        else
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Failed to restore RandR crtc config");
+        }
+    }
 }
 
 
@@ -193,15 +684,15 @@ _GLFWmonitor** _glfwPlatformGetMonitors(int* found)
         RROutput primary;
         XRRScreenResources* sr;
 
-        sr = XRRGetScreenResources(_glfw.x11.display, _glfw.x11.root);
+        sr = _glfwGetScreenResources();
+        if (!sr)
+            return NULL;
 
         primary = XRRGetOutputPrimary(_glfw.x11.display, _glfw.x11.root);
 
         monitors = (_GLFWmonitor**) calloc(sr->noutput, sizeof(_GLFWmonitor*));
         if (!monitors)
         {
-            XRRFreeScreenResources(sr);
-
             _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
             return NULL;
         }
@@ -209,33 +700,19 @@ _GLFWmonitor** _glfwPlatformGetMonitors(int* found)
         for (i = 0;  i < sr->noutput;  i++)
         {
             XRROutputInfo* oi;
-            XRRCrtcInfo* ci;
 
             oi = XRRGetOutputInfo(_glfw.x11.display, sr, sr->outputs[i]);
-            if (oi->connection != RR_Connected)
-            {
-                XRRFreeOutputInfo(oi);
+            if (!oi)
                 continue;
-            }
-
-            ci = XRRGetCrtcInfo(_glfw.x11.display, sr, oi->crtc);
-
-            monitors[*found] = _glfwCreateMonitor(oi->name,
-                                                  sr->outputs[i] == primary,
-                                                  oi->mm_width, oi->mm_height,
-                                                  ci->x, ci->y);
 
-            XRRFreeCrtcInfo(ci);
-
-            if (!monitors[*found])
+            if (oi->connection == RR_Connected)
             {
-                // TODO: wat
-                return NULL;
+                monitors[*found] = createMonitor(sr, sr->outputs[i], oi, primary);
+                if (monitors[*found])
+                    (*found)++;
             }
 
-            // This is retained until the monitor object is destroyed
-            monitors[*found]->x11.output = oi;
-            (*found)++;
+            XRRFreeOutputInfo(oi);
         }
     }
     else
@@ -265,8 +742,6 @@ _GLFWmonitor** _glfwPlatformGetMonitors(int* found)
 
 void _glfwPlatformDestroyMonitor(_GLFWmonitor* monitor)
 {
-    if (_glfw.x11.randr.available)
-        XRRFreeOutputInfo(monitor->x11.output);
 }
 
 GLFWvidmode* _glfwPlatformGetVideoModes(_GLFWmonitor* monitor, int* found)
@@ -284,13 +759,30 @@ GLFWvidmode* _glfwPlatformGetVideoModes(_GLFWmonitor* monitor, int* found)
     if (_glfw.x11.randr.available)
     {
         XRRScreenResources* sr;
-        int i, j, count = monitor->x11.output->nmode;
+        XRROutputInfo* oi;
+        int i, j, count;
 
-        sr = XRRGetScreenResources(_glfw.x11.display, _glfw.x11.root);
+        sr = _glfwGetScreenResources();
+        if (!sr)
+            return NULL;
+
+        // The modes are cached by shared code, so this is only retrieved
+        // again after a configuration change
+        oi = XRRGetOutputInfo(_glfw.x11.display, sr, monitor->x11.output);
+        if (!oi)
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Failed to retrieve RandR output info");
+            return NULL;
+        }
+
+        count = oi->nmode;
 
         result = (GLFWvidmode*) malloc(sizeof(GLFWvidmode) * count);
         if (!result)
         {
+            XRRFreeOutputInfo(oi);
+
             _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
             return NULL;
         }
@@ -298,23 +790,20 @@ GLFWvidmode* _glfwPlatformGetVideoModes(_GLFWmonitor* monitor, int* found)
         for (i = 0;  i < count;  i++)
         {
             GLFWvidmode mode;
+            const XRRModeInfo* mi = getModeInfo(sr, oi->modes[i]);
 
-            for (j = 0;  j < sr->nmode;  j++)
-            {
-                if (sr->modes[j].id == monitor->x11.output->modes[i])
-                    break;
-            }
-
-            if (j == sr->nmode)
+            if (!mi)
                 continue;
 
-            mode.width  = sr->modes[j].width;
-            mode.height = sr->modes[j].height;
+            mode.width  = mi->width;
+            mode.height = mi->height;
+            mode.refreshRate = calculateRefreshRate(mi);
 
             for (j = 0;  j < *found;  j++)
             {
                 if (result[j].width == mode.width &&
-                    result[j].height == mode.height)
+                    result[j].height == mode.height &&
+                    result[j].refreshRate == mode.refreshRate)
                 {
                     break;
                 }
@@ -334,7 +823,7 @@ GLFWvidmode* _glfwPlatformGetVideoModes(_GLFWmonitor* monitor, int* found)
             (*found)++;
         }
 
-        XRRFreeScreenResources(sr);
+        XRRFreeOutputInfo(oi);
     }
     else
     {
@@ -349,6 +838,7 @@ GLFWvidmode* _glfwPlatformGetVideoModes(_GLFWmonitor* monitor, int* found)
 
         result[0].width = DisplayWidth(_glfw.x11.display, _glfw.x11.screen);
         result[0].height = DisplayHeight(_glfw.x11.display, _glfw.x11.screen);
+        result[0].refreshRate = 0;
         result[0].redBits = r;
         result[0].greenBits = g;
         result[0].blueBits = b;
@@ -361,37 +851,15 @@ void _glfwPlatformGetVideoMode(_GLFWmonitor* monitor, GLFWvidmode* mode)
 {
     if (_glfw.x11.randr.available)
     {
-        XRRScreenResources* sr;
-        XRRCrtcInfo* ci;
-
-        sr = XRRGetScreenResources(_glfw.x11.display, _glfw.x11.root);
-        if (!sr)
-        {
-            _glfwInputError(GLFW_PLATFORM_ERROR,
-                            "X11: Failed to retrieve RandR screen resources");
-            return;
-        }
-
-        ci = XRRGetCrtcInfo(_glfw.x11.display, sr, monitor->x11.output->crtc);
-        if (!ci)
-        {
-            XRRFreeScreenResources(sr);
-
-            _glfwInputError(GLFW_PLATFORM_ERROR,
-                            "X11: Failed to retrieve RandR crtc info");
-            return;
-        }
-
-        mode->width = ci->width;
-        mode->height = ci->height;
-
-        XRRFreeCrtcInfo(ci);
-        XRRFreeScreenResources(sr);
+        // The mode is kept up to date from the notifications of the server,
+        // so querying it does not need a round trip
+        *mode = monitor->x11.currentMode;
     }
     else
     {
         mode->width = DisplayWidth(_glfw.x11.display, _glfw.x11.screen);
         mode->height = DisplayHeight(_glfw.x11.display, _glfw.x11.screen);
+        mode->refreshRate = 0;
     }
 
     _glfwSplitBPP(DefaultDepth(_glfw.x11.display, _glfw.x11.screen),
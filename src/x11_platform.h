@@ -34,9 +34,11 @@
 #include <unistd.h>
 #include <signal.h>
 #include <stdint.h>
+#include <pthread.h>
 #include <X11/Xlib.h>
 #include <X11/keysym.h>
 #include <X11/Xatom.h>
+#include <X11/Xutil.h>
 
 // The Xf86VidMode extension provides fallback gamma control
 #include <X11/extensions/xf86vmode.h>
@@ -47,6 +49,11 @@
 // The Xkb extension provides improved keyboard support
 #include <X11/XKBlib.h>
 
+// The evdev interface provides high resolution joystick input
+#if defined(_GLFW_USE_EVDEV)
+ #include <linux/input.h>
+#endif
+
 #if defined(_GLFW_GLX)
  #define _GLFW_X11_CONTEXT_VISUAL window->glx.visual
  #include "glx_platform.h"
@@ -74,6 +81,10 @@
 #define _GLFW_CONVERSION_SUCCEEDED      1
 #define _GLFW_CONVERSION_FAILED         2
 
+// The largest number of joystick axes and buttons in a snapshot
+#define _GLFW_JOYSTICK_MAX_AXES         64
+#define _GLFW_JOYSTICK_MAX_BUTTONS      512
+
 
 //========================================================================
 // GLFW platform specific types
@@ -119,9 +130,19 @@ typedef struct _GLFWlibraryX11
     int             screen;
     Window          root;
 
+    // Context for mapping X11 window handles to GLFW windows
+    XContext        context;
+
+    // Self-pipe used by glfwPostEmptyEvent to wake up a blocked event wait
+    int             emptyEventPipe[2];
+
     // Invisible cursor for hidden cursor mode
     Cursor          cursor;
 
+    // Server time of the last timestamped event, extended past 32 bits
+    Time            lastEventTime;
+    double          eventTime;
+
     // Window manager atoms
     Atom            WM_STATE;
     Atom            WM_DELETE_WINDOW;
@@ -154,6 +175,12 @@ typedef struct _GLFWlibraryX11
         int         versionMajor;
         int         versionMinor;
         GLboolean   gammaBroken;
+        // Cached until the server reports a configuration change
+        XRRScreenResources* resources;
+        // The size of the screen before it was grown to fit a video mode
+        GLboolean   screenChanged;
+        int         oldWidth, oldHeight;
+        int         oldWidthMM, oldHeightMM;
     } randr;
 
     struct {
@@ -191,14 +218,58 @@ typedef struct _GLFWlibraryX11
 
     struct {
         int         present;
+        int         lost;
         int         fd;
         int         numAxes;
         int         numButtons;
         float*      axis;
         unsigned char* button;
         char*       name;
+        char*       path;
+#if defined(_GLFW_USE_EVDEV)
+        // Maps from evdev codes to axis and button indices, or -1
+        int         axisMap[ABS_CNT];
+        int         buttonMap[KEY_CNT - BTN_MISC];
+        struct input_absinfo absInfo[ABS_CNT];
+        GLboolean   monotonic;
+#endif
     } joystick[GLFW_JOYSTICK_LAST + 1];
 
+    // Joystick state as published to the query functions, guarded by
+    // a sequence counter that is odd while the snapshot is being written
+    struct {
+        volatile unsigned int sequence;
+        int         present;
+        int         numAxes;
+        int         numButtons;
+        float       axes[_GLFW_JOYSTICK_MAX_AXES];
+        unsigned char buttons[_GLFW_JOYSTICK_MAX_BUTTONS];
+    } snapshot[GLFW_JOYSTICK_LAST + 1];
+
+    // Joystick sampling thread, with the mutex guarding the device state
+    // shared with it
+    struct {
+        pthread_mutex_t mutex;
+        pthread_t   handle;
+        GLboolean   running;
+        GLboolean   stop;
+        int         wakePipe[2];
+    } joystickThread;
+
+    // True once the joystick interface, including the mutex of the sampling
+    // thread, has been initialized
+    GLboolean       joysticksInitialized;
+
+    // The directories searched and watched for joystick device nodes
+    char*           joystickDirs[2];
+    int             joystickDirCount;
+
+    // Watches for joysticks being connected and disconnected
+    struct {
+        int         fd;
+        int         watches[2];
+    } inotify;
+
 } _GLFWlibraryX11;
 
 
@@ -207,13 +278,14 @@ typedef struct _GLFWlibraryX11
 //------------------------------------------------------------------------
 typedef struct _GLFWmonitorX11
 {
-    GLboolean       modeChanged;
-
-    XRROutputInfo*  output;
-    SizeID          oldSizeID;
-    int             oldWidth;
-    int             oldHeight;
-    Rotation        oldRotation;
+    RROutput        output;
+    RRCrtc          crtc;
+    // The current mode of the crtc, without the color bits, or all zero if
+    // the monitor is disabled
+    GLFWvidmode     currentMode;
+    // The crtc that was changed and its original mode, or None if unchanged
+    RRCrtc          oldCrtc;
+    RRMode          oldMode;
 
 } _GLFWmonitorX11;
 
@@ -238,16 +310,24 @@ int _glfwCreateContext(_GLFWwindow* window,
 void _glfwDestroyContext(_GLFWwindow* window);
 
 // Fullscreen support
-int  _glfwGetClosestVideoMode(_GLFWmonitor* monitor, int* width, int* height);
-void _glfwSetVideoModeMODE(_GLFWmonitor* monitor, int mode);
-void _glfwSetVideoMode(_GLFWmonitor* monitor, int* width, int* height);
+XRRScreenResources* _glfwGetScreenResources(void);
+void _glfwInvalidateScreenResources(void);
+void _glfwUpdateOutput(RROutput output);
+void _glfwUpdateCrtc(RRCrtc crtc, RRMode mode, Rotation rotation, int x, int y);
+void _glfwUpdatePrimaryMonitor(void);
+int  _glfwSetVideoMode(_GLFWmonitor* monitor, const GLFWvidmode* desired);
 void _glfwRestoreVideoMode(_GLFWmonitor* monitor);
 
 // Joystick input
 int  _glfwInitJoysticks(void);
 void _glfwTerminateJoysticks(void);
+void _glfwPollJoystickEvents(void);
+
+// Keyboard mapping
+void _glfwUpdateKeyCodeLUT(int firstKeyCode, int lastKeyCode);
 
 // Unicode support
+void _glfwInitKeySymTable(void);
 long _glfwKeySym2Unicode(KeySym keysym);
 
 // Clipboard handling
@@ -256,6 +336,8 @@ Atom _glfwWriteSelection(XSelectionRequestEvent* request);
 
 // Event processing
 void _glfwProcessPendingEvents(void);
+GLboolean _glfwInitEmptyEventPipe(void);
+void _glfwTerminateEmptyEventPipe(void);
 
 // Window support
 unsigned long _glfwGetWindowProperty(Window window,
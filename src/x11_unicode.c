@@ -30,6 +30,8 @@
 
 #include "internal.h"
 
+#include <assert.h>
+
 
 /*
  * Marcus: This code was originally written by Markus G. Kuhn.
@@ -42,9 +44,10 @@
  * (UCS, Unicode) values.
  *
  * The array keysymtab[] contains pairs of X11 keysym values for graphical
- * characters and the corresponding Unicode value. The function
- * _glfwKeySym2Unicode() maps a keysym onto a Unicode value using a binary
- * search, therefore keysymtab[] must remain SORTED by keysym value.
+ * characters and the corresponding Unicode value. At initialization, these
+ * pairs and the Latin-1 range are expanded into a two-level table indexed
+ * by the high and low bytes of the keysym, so that _glfwKeySym2Unicode()
+ * maps a keysym onto a Unicode value with a constant number of loads.
  *
  * We allow to represent any UCS character in the range U-00000000 to
  * U-00FFFFFF by a keysym value in the range 0x01000000 to 0x01ffffff.
@@ -851,46 +854,89 @@ static struct codepair {
 };
 
 
+//************************************************************************
+//****                  Two-level keysym lookup table                 ****
+//************************************************************************
+
+// The maximum number of 256 entry pages in the lookup table, including the
+// empty page shared by all unused keysym high bytes
+#define _GLFW_KEYSYM_PAGE_COUNT 32
+
+// The page index for each keysym high byte, where zero is the empty page
+static unsigned char keysymPages[256];
+
+// The Unicode value for each keysym low byte of each page, or zero if the
+// keysym has no Unicode value
+static unsigned short keysymTable[_GLFW_KEYSYM_PAGE_COUNT][256];
+
+
+//========================================================================
+// Add a keysym to the lookup table
+//========================================================================
+
+static void addKeySym(unsigned int keysym, unsigned int ucs, int* pageCount)
+{
+    const unsigned int high = keysym >> 8;
+
+    if (!keysymPages[high])
+    {
+        // The page count must be raised if the mapping table grows to
+        // cover more keysym high bytes
+        assert(*pageCount < _GLFW_KEYSYM_PAGE_COUNT);
+        if (*pageCount == _GLFW_KEYSYM_PAGE_COUNT)
+            return;
+
+        keysymPages[high] = (unsigned char) (*pageCount)++;
+    }
+
+    keysymTable[keysymPages[high]][keysym & 0xff] = (unsigned short) ucs;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW internal API                      //////
 //////////////////////////////////////////////////////////////////////////
 
+//========================================================================
+// Build the keysym lookup table
+//========================================================================
+
+void _glfwInitKeySymTable(void)
+{
+    unsigned int i;
+    int pageCount = 1;
+
+    for (i = 0;  i < sizeof(keysymtab) / sizeof(struct codepair);  i++)
+        addKeySym(keysymtab[i].keysym, keysymtab[i].ucs, &pageCount);
+
+    // Latin-1 characters map 1:1 and take precedence over the table
+    for (i = 0x0020;  i <= 0x007e;  i++)
+        addKeySym(i, i, &pageCount);
+
+    for (i = 0x00a0;  i <= 0x00ff;  i++)
+        addKeySym(i, i, &pageCount);
+}
+
+
 //========================================================================
 // Convert X11 KeySym to Unicode
 //========================================================================
 
-long _glfwKeySym2Unicode( KeySym keysym )
+long _glfwKeySym2Unicode(KeySym keysym)
 {
-    int min = 0;
-    int max = sizeof(keysymtab) / sizeof(struct codepair) - 1;
-    int mid;
-
-    /* First check for Latin-1 characters (1:1 mapping) */
-    if( (keysym >= 0x0020 && keysym <= 0x007e) ||
-        (keysym >= 0x00a0 && keysym <= 0x00ff) )
-    { return keysym;
-    }
+    unsigned int ucs;
 
-    /* Also check for directly encoded 24-bit UCS characters */
-    if( (keysym & 0xff000000) == 0x01000000 )
+    // Directly encoded 24-bit UCS characters
+    if ((keysym & 0xff000000) == 0x01000000)
         return keysym & 0x00ffffff;
 
-    /* Binary search in table */
-    while( max >= min )
-    {
-        mid = (min + max) / 2;
-        if( keysymtab[mid].keysym < keysym )
-            min = mid + 1;
-        else if( keysymtab[mid].keysym > keysym )
-            max = mid - 1;
-        else
-        {
-            /* Found it! */
-            return keysymtab[mid].ucs;
-        }
-    }
+    if (keysym > 0xffff)
+        return -1;
+
+    ucs = keysymTable[keysymPages[keysym >> 8]][keysym & 0xff];
+    if (!ucs)
+        return -1;
 
-    /* No matching Unicode value found */
-    return -1;
+    return ucs;
 }
 
@@ -28,10 +28,16 @@
 //
 //========================================================================
 
-#include "internal.h"
+#if defined(__linux__)
+ // Needed for ppoll
+ #define _GNU_SOURCE
+#endif
 
-#include <sys/select.h>
+#include "internal.h"
 
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -138,6 +144,13 @@ static GLboolean createWindow(_GLFWwindow* window,
             return GL_FALSE;
         }
 
+        // Associate the GLFW window with the X11 window handle, so that
+        // events can be mapped back to it without walking the window list
+        XSaveContext(_glfw.x11.display,
+                     window->x11.handle,
+                     _glfw.x11.context,
+                     (XPointer) window);
+
         // Request a window position to be set once the window is shown
         // (see _glfwPlatformShowWindow)
         window->x11.windowPosSet = GL_FALSE;
@@ -315,8 +328,13 @@ static void showCursor(_GLFWwindow* window)
 // Enter fullscreen mode
 //========================================================================
 
-static void enterFullscreenMode(_GLFWwindow* window)
+static GLboolean enterFullscreenMode(_GLFWwindow* window)
 {
+    GLFWvidmode mode;
+
+    if (!_glfwSetVideoMode(window->monitor, &window->videoMode))
+        return GL_FALSE;
+
     if (!_glfw.x11.saver.changed)
     {
         // Remember old screen saver settings
@@ -333,7 +351,10 @@ static void enterFullscreenMode(_GLFWwindow* window)
         _glfw.x11.saver.changed = GL_TRUE;
     }
 
-    _glfwSetVideoMode(window->monitor, &window->width, &window->height);
+    // The window covers the monitor in whatever mode it ended up in
+    _glfwPlatformGetVideoMode(window->monitor, &mode);
+    window->width = mode.width;
+    window->height = mode.height;
 
     if (_glfw.x11.hasEWMH &&
         _glfw.x11.NET_WM_STATE != None &&
@@ -392,10 +413,13 @@ static void enterFullscreenMode(_GLFWwindow* window)
         XRaiseWindow(_glfw.x11.display, window->x11.handle);
         XSetInputFocus(_glfw.x11.display, window->x11.handle,
                        RevertToParent, CurrentTime);
-        XMoveWindow(_glfw.x11.display, window->x11.handle, 0, 0);
+        XMoveWindow(_glfw.x11.display, window->x11.handle,
+                    window->monitor->positionX, window->monitor->positionY);
         XResizeWindow(_glfw.x11.display, window->x11.handle,
                       window->width, window->height);
     }
+
+    return GL_TRUE;
 }
 
 
@@ -455,13 +479,194 @@ static _GLFWwindow* findWindow(Window handle)
 {
     _GLFWwindow* window;
 
-    for (window = _glfw.windowListHead;  window;  window = window->next)
+    if (XFindContext(_glfw.x11.display,
+                     handle,
+                     _glfw.x11.context,
+                     (XPointer*) &window) != 0)
+    {
+        return NULL;
+    }
+
+    return window;
+}
+
+
+//========================================================================
+// Discard all empty events posted by glfwPostEmptyEvent
+//========================================================================
+
+static void drainEmptyEvents(void)
+{
+    char buffer[64];
+
+    while (read(_glfw.x11.emptyEventPipe[0], buffer, sizeof(buffer)) > 0)
+        ;
+}
+
+
+//========================================================================
+// Wait for events to arrive on the X connection, the empty event pipe or
+// any present joystick
+// A negative timeout means waiting indefinitely
+//========================================================================
+
+static GLboolean waitForEvent(double timeout)
+{
+    int i, count = 2;
+    struct pollfd fds[3 + GLFW_JOYSTICK_LAST + 1];
+    const double end = _glfwPlatformGetTime() + timeout;
+
+    // Events that Xlib has already read from the connection will not make it
+    // readable again, so check the client-side queue first
+    // This also flushes the output buffer, so that the server has seen every
+    // request we may be waiting for the results of
+    if (XPending(_glfw.x11.display))
+        return GL_TRUE;
+
+    fds[0].fd = ConnectionNumber(_glfw.x11.display);
+    fds[0].events = POLLIN;
+    fds[1].fd = _glfw.x11.emptyEventPipe[0];
+    fds[1].events = POLLIN;
+
+    // Joystick events and connections are processed by the event pump, so
+    // input on any present joystick or a joystick being connected also ends
+    // the wait
+    if (_glfw.x11.inotify.fd != -1)
     {
-        if (window->x11.handle == handle)
-            return window;
+        fds[count].fd = _glfw.x11.inotify.fd;
+        fds[count].events = POLLIN;
+        count++;
     }
 
-    return NULL;
+    // A joystick sampling thread reads the devices itself and posts an empty
+    // event when one is lost
+    for (i = 0;  i <= GLFW_JOYSTICK_LAST;  i++)
+    {
+        if (!_glfw.x11.joystick[i].present || _glfw.x11.joystickThread.running)
+            continue;
+
+        fds[count].fd = _glfw.x11.joystick[i].fd;
+        fds[count].events = POLLIN;
+        count++;
+    }
+
+    // poll(2) is used instead of an X function like XNextEvent, as the
+    // wait inside those are guarded by the mutex protecting the display
+    // struct, locking out other threads from using X (including GLX)
+    for (;;)
+    {
+        int result;
+
+        if (timeout < 0.0)
+            result = poll(fds, count, -1);
+        else
+        {
+            double remaining = end - _glfwPlatformGetTime();
+            if (remaining < 0.0)
+                remaining = 0.0;
+
+#if defined(__linux__)
+            struct timespec ts;
+            ts.tv_sec = (time_t) remaining;
+            ts.tv_nsec = (long) ((remaining - ts.tv_sec) * 1e9);
+
+            result = ppoll(fds, count, &ts, NULL);
+#else
+            // Round up to avoid waking before the deadline
+            result = poll(fds, count, (int) (remaining * 1e3 + 0.999));
+#endif
+        }
+
+        if (result > 0)
+        {
+            if (fds[1].revents & POLLIN)
+                drainEmptyEvents();
+
+            return GL_TRUE;
+        }
+
+        if (result == 0 || errno != EINTR)
+            return GL_FALSE;
+    }
+}
+
+
+//========================================================================
+// Check whether the specified event is superseded by the next queued event
+//========================================================================
+
+static GLboolean isSuperseded(const XEvent* event)
+{
+    XEvent next;
+    _GLFWwindow* window;
+
+    if (event->type != MotionNotify &&
+        event->type != ConfigureNotify &&
+        event->type != Expose)
+    {
+        return GL_FALSE;
+    }
+
+    window = findWindow(event->xany.window);
+    if (!window || !window->compressEvents)
+        return GL_FALSE;
+
+    // Callbacks may have drained the queue by re-entering the event loop,
+    // and peeking at an empty queue would block until the next event
+    if (!XQLength(_glfw.x11.display))
+        return GL_FALSE;
+
+    // Only the final state of a run of these events is reported, and the
+    // cursor motion deltas of captured cursor mode add up to the same total
+    XPeekEvent(_glfw.x11.display, &next);
+
+    return next.type == event->type &&
+           next.xany.window == event->xany.window;
+}
+
+
+//========================================================================
+// Returns the server timestamp of the specified event, in seconds
+//========================================================================
+
+static double getEventTime(const XEvent* event)
+{
+    Time time;
+
+    switch (event->type)
+    {
+        case KeyPress:
+        case KeyRelease:
+            time = event->xkey.time;
+            break;
+        case ButtonPress:
+        case ButtonRelease:
+            time = event->xbutton.time;
+            break;
+        case MotionNotify:
+            time = event->xmotion.time;
+            break;
+        case EnterNotify:
+        case LeaveNotify:
+            time = event->xcrossing.time;
+            break;
+        default:
+            return -1.0;
+    }
+
+    // Server time is a 32-bit millisecond counter that wraps around after
+    // about 49.7 days, so accumulate the signed difference since the last
+    // timestamp instead of using it directly
+    if (_glfw.x11.lastEventTime)
+    {
+        _glfw.x11.eventTime +=
+            (int) (unsigned int) (time - _glfw.x11.lastEventTime) / 1000.0;
+    }
+    else
+        _glfw.x11.eventTime = time / 1000.0;
+
+    _glfw.x11.lastEventTime = time;
+    return _glfw.x11.eventTime;
 }
 
 
@@ -473,6 +678,88 @@ static void processEvent(XEvent *event)
 {
     _GLFWwindow* window = NULL;
 
+    if (event->type == MappingNotify)
+    {
+        // This is sent to every client and is not tied to any window
+        if (event->xmapping.request == MappingKeyboard)
+        {
+            // Update the mapping cached by Xlib for XLookupString
+            XRefreshKeyboardMapping(&event->xmapping);
+
+            _glfwUpdateKeyCodeLUT(event->xmapping.first_keycode,
+                                  event->xmapping.first_keycode +
+                                  event->xmapping.count - 1);
+        }
+
+        return;
+    }
+
+    if (event->type == _glfw.x11.xkb.eventBase + XkbEventCode)
+    {
+        const XkbEvent* xkb = (const XkbEvent*) event;
+
+        if (xkb->any.xkb_type == XkbNewKeyboardNotify)
+            _glfwUpdateKeyCodeLUT(0, 255);
+        else if (xkb->any.xkb_type == XkbMapNotify)
+        {
+            // Changed key types may affect every key, otherwise only the
+            // key codes whose symbols changed need to be translated again
+            if (xkb->map.changed & XkbKeyTypesMask)
+                _glfwUpdateKeyCodeLUT(0, 255);
+            else if (xkb->map.changed & XkbKeySymsMask)
+            {
+                _glfwUpdateKeyCodeLUT(xkb->map.first_key_sym,
+                                      xkb->map.first_key_sym +
+                                      xkb->map.num_key_syms - 1);
+            }
+        }
+
+        return;
+    }
+
+    if (_glfw.x11.randr.available)
+    {
+        // These are sent for the root window and so not tied to any window
+        if (event->type == _glfw.x11.randr.eventBase + RRScreenChangeNotify)
+        {
+            XRRUpdateConfiguration(event);
+            _glfwInvalidateScreenResources();
+
+            // Outputs and crtcs report their own changes, which leaves only
+            // the choice of primary output to update here
+            _glfwUpdatePrimaryMonitor();
+            return;
+        }
+
+        if (event->type == _glfw.x11.randr.eventBase + RRNotify)
+        {
+            const XRRNotifyEvent* notify = (const XRRNotifyEvent*) event;
+
+            // Output property changes do not affect the screen resources
+            if (notify->subtype == RRNotify_CrtcChange)
+            {
+                const XRRCrtcChangeNotifyEvent* change =
+                    (const XRRCrtcChangeNotifyEvent*) event;
+
+                _glfwInvalidateScreenResources();
+                _glfwUpdateCrtc(change->crtc, change->mode, change->rotation,
+                                change->x, change->y);
+            }
+            else if (notify->subtype == RRNotify_OutputChange)
+            {
+                const XRROutputChangeNotifyEvent* change =
+                    (const XRROutputChangeNotifyEvent*) event;
+
+                // Only the changed output is updated, so the monitors of all
+                // other outputs are left untouched
+                _glfwInvalidateScreenResources();
+                _glfwUpdateOutput(change->output);
+            }
+
+            return;
+        }
+    }
+
     if (event->type != GenericEvent)
     {
         window = findWindow(event->xany.window);
@@ -484,6 +771,8 @@ static void processEvent(XEvent *event)
         }
     }
 
+    _glfwInputEventTime(getEventTime(event));
+
     switch (event->type)
     {
         case KeyPress:
@@ -670,7 +959,11 @@ static void processEvent(XEvent *event)
 
         case Expose:
         {
-            _glfwInputWindowDamage(window);
+            // With compression, only report damage once all rectangles of
+            // the region are known
+            if (!window->compressEvents || event->xexpose.count == 0)
+                _glfwInputWindowDamage(window);
+
             break;
         }
 
@@ -751,19 +1044,7 @@ static void processEvent(XEvent *event)
             return;
 
         default:
-        {
-            switch (event->type - _glfw.x11.randr.eventBase)
-            {
-                case RRScreenChangeNotify:
-                {
-                    XRRUpdateConfiguration(event);
-                    _glfwInputMonitorChange();
-                    break;
-                }
-            }
-
             break;
-        }
     }
 }
 
@@ -772,6 +1053,50 @@ static void processEvent(XEvent *event)
 //////                       GLFW internal API                      //////
 //////////////////////////////////////////////////////////////////////////
 
+//========================================================================
+// Create the non-blocking pipe used to post empty events
+//========================================================================
+
+GLboolean _glfwInitEmptyEventPipe(void)
+{
+    int i;
+
+    if (pipe(_glfw.x11.emptyEventPipe) != 0)
+    {
+        _glfw.x11.emptyEventPipe[0] = _glfw.x11.emptyEventPipe[1] = -1;
+
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Failed to create empty event pipe");
+        return GL_FALSE;
+    }
+
+    for (i = 0;  i < 2;  i++)
+    {
+        const int sf = fcntl(_glfw.x11.emptyEventPipe[i], F_GETFL, 0);
+        const int df = fcntl(_glfw.x11.emptyEventPipe[i], F_GETFD, 0);
+
+        fcntl(_glfw.x11.emptyEventPipe[i], F_SETFL, sf | O_NONBLOCK);
+        fcntl(_glfw.x11.emptyEventPipe[i], F_SETFD, df | FD_CLOEXEC);
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Close the empty event pipe
+//========================================================================
+
+void _glfwTerminateEmptyEventPipe(void)
+{
+    if (_glfw.x11.emptyEventPipe[0] != -1)
+    {
+        close(_glfw.x11.emptyEventPipe[0]);
+        close(_glfw.x11.emptyEventPipe[1]);
+        _glfw.x11.emptyEventPipe[0] = _glfw.x11.emptyEventPipe[1] = -1;
+    }
+}
+
 //========================================================================
 // Retrieve a single window property of the specified type
 // Inspired by fghGetWindowProperty from freeglut
@@ -823,7 +1148,9 @@ int _glfwPlatformCreateWindow(_GLFWwindow* window,
     if (wndconfig->monitor)
     {
         _glfwPlatformShowWindow(window);
-        enterFullscreenMode(window);
+
+        if (!enterFullscreenMode(window))
+            return GL_FALSE;
     }
 
     // Retrieve and set initial cursor position
@@ -858,6 +1185,7 @@ void _glfwPlatformDestroyWindow(_GLFWwindow* window)
 
     if (window->x11.handle)
     {
+        XDeleteContext(_glfw.x11.display, window->x11.handle, _glfw.x11.context);
         XUnmapWindow(_glfw.x11.display, window->x11.handle);
         XDestroyWindow(_glfw.x11.display, window->x11.handle);
         window->x11.handle = (Window) 0;
@@ -907,12 +1235,22 @@ void _glfwPlatformSetWindowTitle(_GLFWwindow* window, const char* title)
 
 void _glfwPlatformSetWindowSize(_GLFWwindow* window, int width, int height)
 {
-    int mode = 0, sizeChanged = GL_FALSE;
+    int sizeChanged = GL_FALSE;
 
     if (window->monitor)
     {
+        const GLFWvidmode* best;
+
+        window->videoMode.width = width;
+        window->videoMode.height = height;
+
         // Get the closest matching video mode for the specified window size
-        mode = _glfwGetClosestVideoMode(window->monitor, &width, &height);
+        best = _glfwChooseVideoMode(window->monitor, &window->videoMode);
+        if (best)
+        {
+            width = best->width;
+            height = best->height;
+        }
     }
 
     if (!window->resizable)
@@ -938,7 +1276,7 @@ void _glfwPlatformSetWindowSize(_GLFWwindow* window, int width, int height)
             sizeChanged = GL_TRUE;
         }
 
-        _glfwSetVideoModeMODE(window->monitor, mode);
+        _glfwSetVideoMode(window->monitor, &window->videoMode);
     }
 
     // Set window size (if not already changed)
@@ -993,14 +1331,46 @@ void _glfwPlatformHideWindow(_GLFWwindow* window)
 
 void _glfwPlatformPollEvents(void)
 {
-    XEvent event;
+    int count;
 
-    while (XCheckMaskEvent(_glfw.x11.display, ~0, &event) ||
-           XCheckTypedEvent(_glfw.x11.display, ClientMessage, &event))
+    // Only the events queued when the drain begins are processed, in the
+    // order they arrived, so the cost is linear in the number of events
+    count = XEventsQueued(_glfw.x11.display, QueuedAfterReading);
+    while (count--)
     {
-        processEvent(&event);
+        // Callbacks may re-enter the event loop, for example to wait for
+        // a selection, and drain events this pass has already counted, so
+        // the queue is checked again to never block in XNextEvent
+        if (!XQLength(_glfw.x11.display))
+            break;
+
+        XEvent event;
+        XNextEvent(_glfw.x11.display, &event);
+
+        // The next event is peeked at only if it is part of this pass
+        if (count > 0 && isSuperseded(&event))
+            continue;
+
+        if (event.type == GenericEvent)
+        {
+            // Extension events (e.g. XInput2) carry their data in a cookie
+            // that has to be fetched and freed around processing
+            if (XGetEventData(_glfw.x11.display, &event.xcookie))
+            {
+                processEvent(&event);
+                XFreeEventData(_glfw.x11.display, &event.xcookie);
+            }
+        }
+        else
+            processEvent(&event);
     }
 
+    // Send any requests made while processing events, such as replies to
+    // window manager pings and selection requests
+    XFlush(_glfw.x11.display);
+
+    _glfwPollJoystickEvents();
+
     // Check whether the cursor has moved inside an focused window that has
     // captured the cursor (because then it needs to be re-centered)
 
@@ -1026,21 +1396,23 @@ void _glfwPlatformPollEvents(void)
 
 void _glfwPlatformWaitEvents(void)
 {
-    int fd;
-    fd_set fds;
-
-    fd = ConnectionNumber(_glfw.x11.display);
+    if (waitForEvent(-1.0))
+        _glfwPlatformPollEvents();
+}
 
-    FD_ZERO(&fds);
-    FD_SET(fd, &fds);
+void _glfwPlatformWaitEventsTimeout(double timeout)
+{
+    waitForEvent(timeout);
+    _glfwPlatformPollEvents();
+}
 
-    XFlush(_glfw.x11.display);
+void _glfwPlatformPostEmptyEvent(void)
+{
+    const char byte = 0;
 
-    // select(1) is used instead of an X function like XNextEvent, as the
-    // wait inside those are guarded by the mutex protecting the display
-    // struct, locking out other threads from using X (including GLX)
-    if (select(fd + 1, &fds, NULL, NULL, NULL) > 0)
-        _glfwPlatformPollEvents();
+    // A full pipe already guarantees a wakeup, so a failed write is harmless
+    if (write(_glfw.x11.emptyEventPipe[1], &byte, 1) < 0)
+        return;
 }
 
 void _glfwPlatformSetCursorPos(_GLFWwindow* window, int x, int y)
@@ -0,0 +1,130 @@
+//========================================================================
+// Event dispatch benchmark
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test measures the cost of dispatching X11 events to GLFW windows as
+// the number of windows grows
+//
+// It sends a burst of synthetic Expose events to the oldest window, which
+// is the last one in the GLFW window list, and times how long it takes
+// glfwPollEvents to deliver them all to the refresh callback
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#define GLFW_EXPOSE_NATIVE_X11
+#define GLFW_EXPOSE_NATIVE_GLX
+#include <GL/glfw3native.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_WINDOWS 64
+#define EVENT_COUNT 20000
+
+static unsigned int counter = 0;
+
+static void error_callback(int error, const char* description)
+{
+    fprintf(stderr, "Error: %s\n", description);
+}
+
+static void window_refresh_callback(GLFWwindow* window)
+{
+    counter++;
+}
+
+static void send_events(GLFWwindow* window, int count)
+{
+    int i;
+    XEvent event;
+    Display* display = glfwGetX11Display();
+
+    memset(&event, 0, sizeof(event));
+    event.type = Expose;
+    event.xexpose.window = glfwGetX11Window(window);
+    event.xexpose.width = 1;
+    event.xexpose.height = 1;
+
+    for (i = 0;  i < count;  i++)
+        XSendEvent(display, event.xexpose.window, False, ExposureMask, &event);
+
+    XSync(display, False);
+}
+
+int main(void)
+{
+    int count = 0, target;
+    GLFWwindow* windows[MAX_WINDOWS];
+
+    glfwSetErrorCallback(error_callback);
+
+    if (!glfwInit())
+        exit(EXIT_FAILURE);
+
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+    printf("%8s %8s %12s\n", "windows", "events", "ns/event");
+
+    for (target = 1;  target <= MAX_WINDOWS;  target *= 2)
+    {
+        double start, elapsed;
+
+        while (count < target)
+        {
+            windows[count] = glfwCreateWindow(64, 64, "Dispatch", NULL, NULL);
+            if (!windows[count])
+            {
+                glfwTerminate();
+                exit(EXIT_FAILURE);
+            }
+
+            count++;
+        }
+
+        // Drain any events generated by window creation
+        glfwPollEvents();
+
+        glfwSetWindowRefreshCallback(windows[0], window_refresh_callback);
+
+        counter = 0;
+        send_events(windows[0], EVENT_COUNT);
+
+        start = glfwGetTime();
+
+        while (counter < EVENT_COUNT)
+            glfwPollEvents();
+
+        elapsed = glfwGetTime() - start;
+
+        printf("%8i %8i %12.1f\n",
+               count, EVENT_COUNT, elapsed * 1e9 / EVENT_COUNT);
+    }
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}
+
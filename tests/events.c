@@ -225,7 +225,7 @@ static void window_pos_callback(GLFWwindow* window, int x, int y)
 {
     printf("%08x at %0.3f: Window position: %i %i\n",
            counter++,
-           glfwGetTime(),
+           glfwGetEventTime(),
            x,
            y);
 }
@@ -234,7 +234,7 @@ static void window_size_callback(GLFWwindow* window, int width, int height)
 {
     printf("%08x at %0.3f: Window size: %i %i\n",
            counter++,
-           glfwGetTime(),
+           glfwGetEventTime(),
            width,
            height);
 
@@ -243,14 +243,14 @@ static void window_size_callback(GLFWwindow* window, int width, int height)
 
 static int window_close_callback(GLFWwindow* window)
 {
-    printf("%08x at %0.3f: Window close\n", counter++, glfwGetTime());
+    printf("%08x at %0.3f: Window close\n", counter++, glfwGetEventTime());
 
     return closeable;
 }
 
 static void window_refresh_callback(GLFWwindow* window)
 {
-    printf("%08x at %0.3f: Window refresh\n", counter++, glfwGetTime());
+    printf("%08x at %0.3f: Window refresh\n", counter++, glfwGetEventTime());
 
     if (glfwGetCurrentContext())
     {
@@ -263,7 +263,7 @@ static void window_focus_callback(GLFWwindow* window, int focused)
 {
     printf("%08x at %0.3f: Window %s\n",
            counter++,
-           glfwGetTime(),
+           glfwGetEventTime(),
            focused ? "focused" : "defocused");
 }
 
@@ -271,7 +271,7 @@ static void window_iconify_callback(GLFWwindow* window, int iconified)
 {
     printf("%08x at %0.3f: Window was %s\n",
            counter++,
-           glfwGetTime(),
+           glfwGetEventTime(),
            iconified ? "iconified" : "restored");
 }
 
@@ -279,7 +279,7 @@ static void mouse_button_callback(GLFWwindow* window, int button, int action)
 {
     const char* name = get_button_name(button);
 
-    printf("%08x at %0.3f: Mouse button %i", counter++, glfwGetTime(), button);
+    printf("%08x at %0.3f: Mouse button %i", counter++, glfwGetEventTime(), button);
 
     if (name)
         printf(" (%s) was %s\n", name, get_action_name(action));
@@ -289,27 +289,27 @@ static void mouse_button_callback(GLFWwindow* window, int button, int action)
 
 static void cursor_position_callback(GLFWwindow* window, int x, int y)
 {
-    printf("%08x at %0.3f: Cursor position: %i %i\n", counter++, glfwGetTime(), x, y);
+    printf("%08x at %0.3f: Cursor position: %i %i\n", counter++, glfwGetEventTime(), x, y);
 }
 
 static void cursor_enter_callback(GLFWwindow* window, int entered)
 {
     printf("%08x at %0.3f: Cursor %s window\n",
            counter++,
-           glfwGetTime(),
+           glfwGetEventTime(),
            entered ? "entered" : "left");
 }
 
 static void scroll_callback(GLFWwindow* window, double x, double y)
 {
-    printf("%08x at %0.3f: Scroll: %0.3f %0.3f\n", counter++, glfwGetTime(), x, y);
+    printf("%08x at %0.3f: Scroll: %0.3f %0.3f\n", counter++, glfwGetEventTime(), x, y);
 }
 
 static void key_callback(GLFWwindow* window, int key, int action)
 {
     const char* name = get_key_name(key);
 
-    printf("%08x at %0.3f: Key 0x%04x", counter++, glfwGetTime(), key);
+    printf("%08x at %0.3f: Key 0x%04x", counter++, glfwGetEventTime(), key);
 
     if (name)
         printf(" (%s) was %s\n", name, get_action_name(action));
@@ -335,7 +335,7 @@ static void char_callback(GLFWwindow* window, int character)
 {
     printf("%08x at %0.3f: Character 0x%04x (%s) input\n",
            counter++,
-           glfwGetTime(),
+           glfwGetEventTime(),
            character,
            get_character_string(character));
 }
@@ -365,10 +365,44 @@ void monitor_callback(GLFWmonitor* monitor, int event)
     }
 }
 
+void joystick_callback(int joy, int event)
+{
+    if (event == GLFW_CONNECTED)
+    {
+        printf("%08x at %0.3f: Joystick %i (%s with %i axes, %i buttons) was connected\n",
+               counter++,
+               glfwGetTime(),
+               joy + 1,
+               glfwGetJoystickName(joy),
+               glfwGetJoystickParam(joy, GLFW_AXES),
+               glfwGetJoystickParam(joy, GLFW_BUTTONS));
+    }
+    else
+    {
+        printf("%08x at %0.3f: Joystick %i was disconnected\n",
+               counter++,
+               glfwGetTime(),
+               joy + 1);
+    }
+}
+
+void joystick_axis_callback(int joy, int axis, float value)
+{
+    printf("%08x at %0.3f: Joystick %i axis %i moved to %0.3f\n",
+           counter++, glfwGetTime(), joy + 1, axis, value);
+}
+
+void joystick_button_callback(int joy, int button, int action)
+{
+    printf("%08x at %0.3f: Joystick %i button %i was %s\n",
+           counter++, glfwGetTime(), joy + 1, button,
+           action == GLFW_PRESS ? "pressed" : "released");
+}
+
 int main(void)
 {
     GLFWwindow* window;
-    int width, height;
+    int width, height, joy, axis;
 
     setlocale(LC_ALL, "");
 
@@ -389,6 +423,16 @@ int main(void)
     printf("Window opened\n");
 
     glfwSetMonitorCallback(monitor_callback);
+    glfwSetJoystickCallback(joystick_callback);
+    glfwSetJoystickAxisCallback(joystick_axis_callback);
+    glfwSetJoystickButtonCallback(joystick_button_callback);
+
+    // Analog sticks jitter at rest, so only report noticeable movement
+    for (joy = GLFW_JOYSTICK_1;  joy <= GLFW_JOYSTICK_LAST;  joy++)
+    {
+        for (axis = 0;  axis < 8;  axis++)
+            glfwSetJoystickAxisThreshold(joy, axis, 0.05f);
+    }
 
     glfwSetWindowPosCallback(window, window_pos_callback);
     glfwSetWindowSizeCallback(window, window_size_callback);
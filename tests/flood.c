@@ -0,0 +1,143 @@
+//========================================================================
+// Event flood benchmark
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test measures how many events per second glfwPollEvents can drain
+// when the Xlib event queue is flooded with pointer motion
+//
+// The motion is generated with the XTest extension, so the window must end
+// up under the pointer.  It is intended to be run on an X server without a
+// window manager, for example:
+//
+//   xvfb-run ./flood
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#define GLFW_EXPOSE_NATIVE_X11
+#define GLFW_EXPOSE_NATIVE_GLX
+#include <GL/glfw3native.h>
+
+#include <X11/extensions/XTest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static unsigned int counter = 0;
+
+static void error_callback(int error, const char* description)
+{
+    fprintf(stderr, "Error: %s\n", description);
+}
+
+static void cursor_position_callback(GLFWwindow* window, int x, int y)
+{
+    counter++;
+}
+
+static void flood(GLFWwindow* window, unsigned int count)
+{
+    unsigned int i;
+    Display* display = glfwGetX11Display();
+    const int x = glfwGetWindowParam(window, GLFW_POSITION_X) + 10;
+    const int y = glfwGetWindowParam(window, GLFW_POSITION_Y) + 10;
+
+    // Alternate between two positions so every event is a real motion
+    for (i = 0;  i < count;  i++)
+        XTestFakeMotionEvent(display, -1, x + (i & 1), y, CurrentTime);
+
+    // Wait for the server to process the requests, which pulls all
+    // resulting events into the Xlib queue before the drain is timed
+    XSync(display, False);
+}
+
+int main(void)
+{
+    unsigned int count;
+    int eventBase, errorBase, major, minor;
+    GLFWwindow* window;
+
+    glfwSetErrorCallback(error_callback);
+
+    if (!glfwInit())
+        exit(EXIT_FAILURE);
+
+    if (!XTestQueryExtension(glfwGetX11Display(),
+                             &eventBase, &errorBase, &major, &minor))
+    {
+        fprintf(stderr, "The XTest extension is not available\n");
+
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    glfwWindowHint(GLFW_POSITION_X, 0);
+    glfwWindowHint(GLFW_POSITION_Y, 0);
+
+    window = glfwCreateWindow(200, 200, "Event Flood", NULL, NULL);
+    if (!window)
+    {
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    glfwSetCursorPosCallback(window, cursor_position_callback);
+
+    // Let the window get mapped and the pointer settle inside it
+    flood(window, 2);
+    glfwPollEvents();
+
+    printf("%10s %14s\n", "events", "events/sec");
+
+    for (count = 1000;  count <= 100000;  count *= 10)
+    {
+        double start, elapsed;
+
+        counter = 0;
+        flood(window, count);
+
+        start = glfwGetTime();
+
+        while (counter < count)
+        {
+            glfwPollEvents();
+
+            if (glfwGetTime() - start > 10.0)
+            {
+                fprintf(stderr, "Timed out after %u of %u events\n",
+                        counter, count);
+                break;
+            }
+        }
+
+        elapsed = glfwGetTime() - start;
+
+        printf("%10u %14.0f\n", counter, counter / elapsed);
+    }
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}
+
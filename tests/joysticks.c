@@ -24,7 +24,7 @@
 //========================================================================
 //
 // This test displays the state of every button and axis of every connected
-// joystick and/or gamepad
+// joystick and/or gamepad, and outputs every change in their history
 //
 //========================================================================
 
@@ -188,6 +188,34 @@ static void refresh_joysticks(void)
     }
 }
 
+static void print_joystick_events(void)
+{
+    int i, j, count;
+    GLFWjoystickevent events[64];
+
+    for (i = 0;  i < sizeof(joysticks) / sizeof(Joystick);  i++)
+    {
+        while ((count = glfwGetJoystickEvents(GLFW_JOYSTICK_1 + i, events, 64)))
+        {
+            for (j = 0;  j < count;  j++)
+            {
+                if (events[j].type == GLFW_JOYSTICK_AXIS_EVENT)
+                {
+                    printf("%0.3f: Joystick %i axis %i moved to %0.3f\n",
+                           events[j].time, i + 1, events[j].index,
+                           events[j].data.value);
+                }
+                else
+                {
+                    printf("%0.3f: Joystick %i button %i was %s\n",
+                           events[j].time, i + 1, events[j].index,
+                           events[j].data.action == GLFW_PRESS ? "pressed" : "released");
+                }
+            }
+        }
+    }
+}
+
 int main(void)
 {
     GLFWwindow* window;
@@ -216,6 +244,7 @@ int main(void)
         glClear(GL_COLOR_BUFFER_BIT);
 
         refresh_joysticks();
+        print_joystick_events();
         draw_joysticks(window);
 
         glfwSwapBuffers(window);
@@ -0,0 +1,311 @@
+//========================================================================
+// Joystick read batching benchmark
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test points GLFW_JOYSTICK_DIR at a directory holding a FIFO, which
+// GLFW then reads as a joystick, and feeds axis events through it at
+// increasing rates while processing events once per frame
+//
+// It interposes read to count the calls GLFW makes on the device, and
+// reports them per second of input along with the number of events read
+// per call and the time spent processing events, so it needs an X server
+// but no joystick
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+// The event format depends on the joystick backend GLFW was built with
+#include "config.h"
+
+#if defined(_GLFW_USE_EVDEV)
+ #include <linux/input.h>
+ #define DEVICE_NAME "event0"
+ typedef struct input_event Event;
+#else
+ #include <linux/joystick.h>
+ #define DEVICE_NAME "js0"
+ typedef struct js_event Event;
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FRAME_RATE 60
+#define BATCH_SIZE 64
+#define AXIS_COUNT 20
+
+// The descriptor GLFW opened for the FIFO
+static int device = -1;
+
+static unsigned long calls = 0;
+static unsigned long received = 0;
+
+// This replaces the C library function for GLFW as well as for this file
+ssize_t read(int fd, void* buffer, size_t size)
+{
+    if (fd == device)
+        calls++;
+
+    return syscall(SYS_read, fd, buffer, size);
+}
+
+static void usage(void)
+{
+    printf("Usage: jsbench [-h] [-s SECONDS]\n");
+}
+
+static void error_callback(int error, const char* description)
+{
+    fprintf(stderr, "Error: %s\n", description);
+}
+
+static void axis_callback(int joy, int axis, float value)
+{
+    received++;
+}
+
+// Finds the descriptor other than our own that refers to the FIFO
+static int find_device(const char* path, int own)
+{
+    int fd, result = -1;
+    DIR* dir;
+    struct dirent* entry;
+
+    dir = opendir("/proc/self/fd");
+    if (!dir)
+        return -1;
+
+    while ((entry = readdir(dir)))
+    {
+        char link[64], target[256];
+        ssize_t length;
+
+        fd = atoi(entry->d_name);
+        if (entry->d_name[0] == '.' || fd == own || fd == dirfd(dir))
+            continue;
+
+        snprintf(link, sizeof(link), "/proc/self/fd/%s", entry->d_name);
+
+        length = readlink(link, target, sizeof(target) - 1);
+        if (length < 0)
+            continue;
+
+        target[length] = '\0';
+        if (strcmp(target, path) == 0)
+        {
+            result = fd;
+            break;
+        }
+    }
+
+    closedir(dir);
+    return result;
+}
+
+static void set_event(Event* event, int axis, short value)
+{
+    memset(event, 0, sizeof(Event));
+
+#if defined(_GLFW_USE_EVDEV)
+    event->type = EV_ABS;
+    event->code = axis;
+    event->value = value;
+#else
+    event->type = JS_EVENT_AXIS;
+    event->number = axis;
+    event->value = value;
+#endif
+}
+
+// Writes the specified number of random axis events, processing events
+// whenever the FIFO is full
+static double feed(int fd, int count)
+{
+    int i;
+    double elapsed = 0.0;
+    Event events[BATCH_SIZE];
+
+    while (count > 0)
+    {
+        const int batch = count < BATCH_SIZE ? count : BATCH_SIZE;
+
+        for (i = 0;  i < batch;  i++)
+            set_event(events + i, i % AXIS_COUNT, (short) (rand() - RAND_MAX / 2));
+
+        if (write(fd, events, batch * sizeof(Event)) < 0)
+        {
+            const double start = glfwGetTime();
+
+            if (errno != EAGAIN)
+            {
+                fprintf(stderr, "Failed to write to FIFO: %s\n", strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+
+            glfwPollEvents();
+            elapsed += glfwGetTime() - start;
+            continue;
+        }
+
+        count -= batch;
+    }
+
+    return elapsed;
+}
+
+static void run(int fd, int rate, int seconds)
+{
+    int frame;
+    double elapsed = 0.0;
+    const int frames = seconds * FRAME_RATE;
+
+    calls = received = 0;
+
+    for (frame = 0;  frame < frames;  frame++)
+    {
+        double start;
+
+        elapsed += feed(fd, rate / FRAME_RATE);
+
+        start = glfwGetTime();
+        glfwPollEvents();
+        elapsed += glfwGetTime() - start;
+    }
+
+    printf("%10i %14.0f %12.0f %12.1f %12.3f\n",
+           rate,
+           (double) received / seconds,
+           (double) calls / seconds,
+           calls ? (double) received / calls : 0.0,
+           elapsed * 1e3 / seconds);
+}
+
+int main(int argc, char** argv)
+{
+    int i, ch, fd, seconds = 2;
+    char dir[] = "/tmp/jsbenchXXXXXX";
+    char staging[sizeof(dir) + 16];
+    char path[sizeof(dir) + 16];
+    const int rates[] = { 1000, 20000, 100000, 400000 };
+
+    while ((ch = getopt(argc, argv, "hs:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+
+            case 's':
+                seconds = atoi(optarg);
+                break;
+
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (seconds < 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (!mkdtemp(dir))
+    {
+        fprintf(stderr, "Failed to create directory: %s\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    snprintf(staging, sizeof(staging), "%s/staging", dir);
+    snprintf(path, sizeof(path), "%s/%s", dir, DEVICE_NAME);
+
+    // The FIFO is opened under a name GLFW ignores and then renamed, so that
+    // GLFW never sees it without a writer
+    if (mkfifo(staging, 0600) != 0)
+    {
+        fprintf(stderr, "Failed to create FIFO: %s\n", strerror(errno));
+        rmdir(dir);
+        exit(EXIT_FAILURE);
+    }
+
+    // Opening for both reading and writing does not wait for a reader
+    fd = open(staging, O_RDWR | O_NONBLOCK);
+    if (fd == -1 || rename(staging, path) != 0)
+    {
+        fprintf(stderr, "Failed to set up FIFO: %s\n", strerror(errno));
+        unlink(staging);
+        rmdir(dir);
+        exit(EXIT_FAILURE);
+    }
+
+    setenv("GLFW_JOYSTICK_DIR", dir, 1);
+
+    glfwSetErrorCallback(error_callback);
+
+    if (!glfwInit())
+    {
+        unlink(path);
+        rmdir(dir);
+        exit(EXIT_FAILURE);
+    }
+
+    device = find_device(path, fd);
+    if (device == -1 || !glfwGetJoystickParam(GLFW_JOYSTICK_1, GLFW_PRESENT))
+    {
+        fprintf(stderr, "Emulated joystick was not detected\n");
+
+        glfwTerminate();
+        unlink(path);
+        rmdir(dir);
+        exit(EXIT_FAILURE);
+    }
+
+    glfwSetJoystickAxisCallback(axis_callback);
+
+    printf("%10s %14s %12s %12s %12s\n",
+           "events/s", "received/s", "reads/s", "events/read", "ms/s");
+
+    for (i = 0;  i < sizeof(rates) / sizeof(rates[0]);  i++)
+        run(fd, rates[i], seconds);
+
+    glfwTerminate();
+
+    close(fd);
+    unlink(path);
+    rmdir(dir);
+
+    exit(EXIT_SUCCESS);
+}
+
@@ -0,0 +1,428 @@
+//========================================================================
+// Emulated joystick throughput and latency test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test points GLFW_JOYSTICK_DIR at a directory holding a FIFO, which
+// GLFW then reads as a joystick, so it needs an X server but no joystick
+//
+// It first feeds axis events at increasing rates and processes them once
+// per frame, reporting how many reached the axis callback and the time
+// spent processing events per second of input
+//
+// It then measures the latency from writing a single axis event to its
+// delivery, both by glfwWaitEvents and, where supported, by the joystick
+// sampling thread
+//
+// With the event device backend it also checks that the recorded time of
+// each delivered event is the time it was written, not the time it was read
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+// The event format depends on the joystick backend GLFW was built with
+#include "config.h"
+
+#if defined(_GLFW_USE_EVDEV)
+ #include <linux/input.h>
+ #define DEVICE_NAME "event0"
+ typedef struct input_event Event;
+#else
+ #include <linux/joystick.h>
+ #define DEVICE_NAME "js0"
+ typedef struct js_event Event;
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FRAME_RATE 60
+#define BATCH_SIZE 64
+#define AXIS_COUNT 20
+#define LATENCY_SAMPLES 1000
+#define HISTORY_SIZE 64
+
+static GLboolean failed = GL_FALSE;
+static unsigned long callbacks = 0;
+static double delivered = 0.0;
+
+static void usage(void)
+{
+    printf("Usage: jsfifo [-h] [-s SECONDS]\n");
+}
+
+static void error_callback(int error, const char* description)
+{
+    fprintf(stderr, "Error: %s\n", description);
+    failed = GL_TRUE;
+}
+
+static void axis_callback(int joy, int axis, float value)
+{
+    callbacks++;
+    delivered = glfwGetTime();
+}
+
+static void set_event(Event* event, int axis, short value)
+{
+    memset(event, 0, sizeof(Event));
+
+#if defined(_GLFW_USE_EVDEV)
+    {
+        // GLFW expects FIFO events to be timestamped with the monotonic clock
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        event->time.tv_sec = ts.tv_sec;
+        event->time.tv_usec = ts.tv_nsec / 1000;
+    }
+
+    event->type = EV_ABS;
+    event->code = axis;
+    event->value = value;
+#else
+    event->type = JS_EVENT_AXIS;
+    event->number = axis;
+    event->value = value;
+#endif
+}
+
+// Writes the specified number of random axis events, processing events
+// whenever the FIFO is full
+static double feed(int fd, int count)
+{
+    int i;
+    double elapsed = 0.0;
+    Event events[BATCH_SIZE];
+
+    while (count > 0)
+    {
+        const int batch = count < BATCH_SIZE ? count : BATCH_SIZE;
+
+        for (i = 0;  i < batch;  i++)
+            set_event(events + i, i % AXIS_COUNT, (short) (rand() - RAND_MAX / 2));
+
+        if (write(fd, events, batch * sizeof(Event)) < 0)
+        {
+            const double start = glfwGetTime();
+
+            if (errno != EAGAIN)
+            {
+                fprintf(stderr, "Failed to write to FIFO: %s\n", strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+
+            glfwPollEvents();
+            elapsed += glfwGetTime() - start;
+            continue;
+        }
+
+        count -= batch;
+    }
+
+    return elapsed;
+}
+
+static void test_throughput(int fd, int rate, int seconds)
+{
+    int frame;
+    double elapsed = 0.0;
+    const int frames = seconds * FRAME_RATE;
+
+    callbacks = 0;
+
+    for (frame = 0;  frame < frames;  frame++)
+    {
+        double start;
+
+        elapsed += feed(fd, rate / FRAME_RATE);
+
+        start = glfwGetTime();
+        glfwPollEvents();
+        elapsed += glfwGetTime() - start;
+    }
+
+    printf("%10i %14.0f %12.3f\n",
+           rate,
+           (double) callbacks / seconds,
+           elapsed * 1e3 / seconds);
+}
+
+static void print_latency(const char* name, double total, double slowest)
+{
+    printf("%10s %12.1f %12.1f\n",
+           name, total * 1e6 / LATENCY_SAMPLES, slowest * 1e6);
+}
+
+// Discards the joystick history, which overflowed during the throughput test
+static void clear_history(void)
+{
+    GLFWjoystickevent history[HISTORY_SIZE];
+
+    glfwSetErrorCallback(NULL);
+
+    while (glfwGetJoystickEvents(GLFW_JOYSTICK_1, history, HISTORY_SIZE))
+        ;
+
+    glfwSetErrorCallback(error_callback);
+}
+
+// Checks that the last recorded change has the time it was written, which
+// was between the specified times
+static GLboolean check_timestamp(double start, double written)
+{
+    GLFWjoystickevent history[HISTORY_SIZE];
+    const int count = glfwGetJoystickEvents(GLFW_JOYSTICK_1, history, HISTORY_SIZE);
+
+    if (count == 0)
+        return GL_FALSE;
+
+#if defined(_GLFW_USE_EVDEV)
+    // The time must be from before the event was read, allowing for the
+    // microsecond resolution of event timestamps
+    return history[count - 1].time >= start - 1e-6 &&
+           history[count - 1].time <= written + 1e-6;
+#else
+    // Joystick API timestamps are on an unspecified clock, so changes are
+    // dated when they are read
+    return GL_TRUE;
+#endif
+}
+
+static void test_event_latency(int fd)
+{
+    int i;
+    Event event;
+    double total = 0.0, slowest = 0.0;
+    int misdated = 0;
+
+    clear_history();
+
+    for (i = 0;  i < LATENCY_SAMPLES;  i++)
+    {
+        double start, written;
+        const unsigned long before = callbacks;
+
+        start = glfwGetTime();
+
+        set_event(&event, 0, (i & 1) ? 16384 : -16384);
+
+        if (write(fd, &event, sizeof(event)) < 0)
+        {
+            fprintf(stderr, "Failed to write to FIFO: %s\n", strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+
+        // The event is only read once events are processed below
+        written = glfwGetTime();
+
+        while (callbacks == before)
+        {
+            if (glfwGetTime() - start > 1.0)
+            {
+                fprintf(stderr, "Axis event was not delivered\n");
+                exit(EXIT_FAILURE);
+            }
+
+            glfwWaitEventsTimeout(1.0);
+        }
+
+        total += delivered - start;
+        if (delivered - start > slowest)
+            slowest = delivered - start;
+
+        if (!check_timestamp(start, written))
+            misdated++;
+    }
+
+    print_latency("events", total, slowest);
+
+    if (misdated)
+    {
+        fprintf(stderr, "%i of %i events were not timestamped when written\n",
+                misdated, LATENCY_SAMPLES);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void test_thread_latency(int fd)
+{
+    int i;
+    Event event;
+    double total = 0.0, slowest = 0.0;
+
+    failed = GL_FALSE;
+    glfwJoystickHint(GLFW_JOYSTICK_POLLING, GLFW_POLL_ON_THREAD);
+    if (failed)
+        return;
+
+    for (i = 0;  i < LATENCY_SAMPLES;  i++)
+    {
+        float axis = 0.f;
+        double start, latency;
+        const int positive = i & 1;
+
+        set_event(&event, 0, positive ? 16384 : -16384);
+
+        start = glfwGetTime();
+        if (write(fd, &event, sizeof(event)) < 0)
+        {
+            fprintf(stderr, "Failed to write to FIFO: %s\n", strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+
+        for (;;)
+        {
+            glfwGetJoystickAxes(GLFW_JOYSTICK_1, &axis, 1);
+            if ((axis > 0.f) == positive && axis != 0.f)
+                break;
+
+            if (glfwGetTime() - start > 1.0)
+            {
+                fprintf(stderr, "Axis event was not sampled\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        latency = glfwGetTime() - start;
+
+        total += latency;
+        if (latency > slowest)
+            slowest = latency;
+    }
+
+    print_latency("thread", total, slowest);
+
+    glfwJoystickHint(GLFW_JOYSTICK_POLLING, GLFW_POLL_ON_EVENTS);
+}
+
+int main(int argc, char** argv)
+{
+    int i, ch, fd, seconds = 2;
+    char dir[] = "/tmp/jsfifoXXXXXX";
+    char staging[sizeof(dir) + 16];
+    char path[sizeof(dir) + 16];
+    const int rates[] = { 1000, 20000, 100000 };
+
+    while ((ch = getopt(argc, argv, "hs:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+
+            case 's':
+                seconds = atoi(optarg);
+                break;
+
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (seconds < 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (!mkdtemp(dir))
+    {
+        fprintf(stderr, "Failed to create directory: %s\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    snprintf(staging, sizeof(staging), "%s/staging", dir);
+    snprintf(path, sizeof(path), "%s/%s", dir, DEVICE_NAME);
+
+    // The FIFO is opened for writing under a name GLFW ignores and then
+    // renamed, so that GLFW never sees it without a writer, which it would
+    // take as the joystick being disconnected
+    if (mkfifo(staging, 0600) != 0)
+    {
+        fprintf(stderr, "Failed to create FIFO: %s\n", strerror(errno));
+        rmdir(dir);
+        exit(EXIT_FAILURE);
+    }
+
+    // Opening for both reading and writing does not wait for a reader
+    fd = open(staging, O_RDWR | O_NONBLOCK);
+    if (fd == -1 || rename(staging, path) != 0)
+    {
+        fprintf(stderr, "Failed to set up FIFO: %s\n", strerror(errno));
+        unlink(staging);
+        rmdir(dir);
+        exit(EXIT_FAILURE);
+    }
+
+    setenv("GLFW_JOYSTICK_DIR", dir, 1);
+
+    glfwSetErrorCallback(error_callback);
+
+    if (!glfwInit())
+    {
+        unlink(path);
+        rmdir(dir);
+        exit(EXIT_FAILURE);
+    }
+
+    if (!glfwGetJoystickParam(GLFW_JOYSTICK_1, GLFW_PRESENT))
+    {
+        fprintf(stderr, "Emulated joystick was not detected\n");
+
+        glfwTerminate();
+        unlink(path);
+        rmdir(dir);
+        exit(EXIT_FAILURE);
+    }
+
+    glfwSetJoystickAxisCallback(axis_callback);
+
+    printf("%10s %14s %12s\n", "events/s", "callbacks/s", "ms/s");
+
+    for (i = 0;  i < sizeof(rates) / sizeof(rates[0]);  i++)
+        test_throughput(fd, rates[i], seconds);
+
+    printf("\n%10s %12s %12s\n", "delivery", "mean us", "max us");
+
+    test_event_latency(fd);
+    test_thread_latency(fd);
+
+    glfwTerminate();
+
+    close(fd);
+    unlink(path);
+    rmdir(dir);
+
+    exit(EXIT_SUCCESS);
+}
+
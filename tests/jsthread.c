@@ -0,0 +1,171 @@
+//========================================================================
+// Joystick sampling thread test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test enables joystick polling on a thread and queries every joystick
+// at 1 kHz from a secondary thread, the way a physics loop would, while the
+// main thread waits for events
+//
+// Once a second it reports how many queries were made, how many of them saw
+// new joystick state and the slowest query
+//
+//========================================================================
+
+#include "tinycthread.h"
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_AXES 64
+#define MAX_BUTTONS 512
+
+static volatile GLboolean running = GL_TRUE;
+
+static volatile unsigned long queries = 0;
+static volatile unsigned long changes = 0;
+static volatile double slowest = 0.0;
+
+static void error_callback(int error, const char* description)
+{
+    fprintf(stderr, "Error: %s\n", description);
+}
+
+static void joystick_callback(int joy, int event)
+{
+    printf("Joystick %i was %s\n",
+           joy + 1,
+           event == GLFW_CONNECTED ? "connected" : "disconnected");
+}
+
+static int thread_main(void* data)
+{
+    int joy;
+    struct timespec time;
+    static float axes[GLFW_JOYSTICK_LAST + 1][MAX_AXES];
+    static unsigned char buttons[GLFW_JOYSTICK_LAST + 1][MAX_BUTTONS];
+
+    clock_gettime(CLOCK_REALTIME, &time);
+
+    while (running)
+    {
+        for (joy = GLFW_JOYSTICK_1;  joy <= GLFW_JOYSTICK_LAST;  joy++)
+        {
+            int numAxes, numButtons;
+            float newAxes[MAX_AXES];
+            unsigned char newButtons[MAX_BUTTONS];
+            const double start = glfwGetTime();
+
+            if (!glfwGetJoystickParam(joy, GLFW_PRESENT))
+                continue;
+
+            numAxes = glfwGetJoystickAxes(joy, newAxes, MAX_AXES);
+            numButtons = glfwGetJoystickButtons(joy, newButtons, MAX_BUTTONS);
+
+            if (glfwGetTime() - start > slowest)
+                slowest = glfwGetTime() - start;
+
+            if (memcmp(axes[joy], newAxes, numAxes * sizeof(float)) != 0 ||
+                memcmp(buttons[joy], newButtons, numButtons) != 0)
+            {
+                memcpy(axes[joy], newAxes, numAxes * sizeof(float));
+                memcpy(buttons[joy], newButtons, numButtons);
+                changes++;
+            }
+
+            queries++;
+        }
+
+        time.tv_nsec += 1000000;
+        if (time.tv_nsec >= 1000000000)
+        {
+            time.tv_nsec -= 1000000000;
+            time.tv_sec++;
+        }
+
+        thrd_sleep(&time, NULL);
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    int result;
+    double last;
+    thrd_t thread;
+    GLFWwindow* window;
+
+    glfwSetErrorCallback(error_callback);
+
+    if (!glfwInit())
+        exit(EXIT_FAILURE);
+
+    glfwJoystickHint(GLFW_JOYSTICK_POLLING, GLFW_POLL_ON_THREAD);
+    glfwSetJoystickCallback(joystick_callback);
+
+    window = glfwCreateWindow(640, 480, "Joystick Thread Test", NULL, NULL);
+    if (!window)
+    {
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    if (thrd_create(&thread, thread_main, NULL) != thrd_success)
+    {
+        fprintf(stderr, "Failed to create secondary thread\n");
+
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    last = glfwGetTime();
+
+    while (running)
+    {
+        glfwWaitEventsTimeout(1.0);
+
+        if (glfwGetTime() - last >= 1.0)
+        {
+            printf("%lu queries, %lu with new state, slowest %0.3f ms\n",
+                   queries, changes, slowest * 1e3);
+
+            queries = changes = 0;
+            slowest = 0.0;
+            last = glfwGetTime();
+        }
+
+        if (glfwGetWindowParam(window, GLFW_SHOULD_CLOSE))
+            running = GL_FALSE;
+    }
+
+    thrd_join(thread, &result);
+    glfwDestroyWindow(window);
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}
+
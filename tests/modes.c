@@ -54,10 +54,11 @@ static const char* format_mode(const GLFWvidmode* mode)
     static char buffer[512];
 
     sprintf(buffer,
-            "%i x %i x %i (%i %i %i)",
+            "%i x %i x %i (%i %i %i) %i Hz",
             mode->width, mode->height,
             mode->redBits + mode->greenBits + mode->blueBits,
-            mode->redBits, mode->greenBits, mode->blueBits);
+            mode->redBits, mode->greenBits, mode->blueBits,
+            mode->refreshRate);
 
     buffer[sizeof(buffer) - 1] = '\0';
     return buffer;
@@ -135,6 +136,7 @@ static void test_modes(GLFWmonitor* monitor)
         glfwWindowHint(GLFW_RED_BITS, mode->redBits);
         glfwWindowHint(GLFW_GREEN_BITS, mode->greenBits);
         glfwWindowHint(GLFW_BLUE_BITS, mode->blueBits);
+        glfwWindowHint(GLFW_REFRESH_RATE, mode->refreshRate);
 
         printf("Testing mode %u on monitor %s: %s\n",
                (unsigned int) i,
@@ -199,6 +201,13 @@ static void test_modes(GLFWmonitor* monitor)
                    mode->width, mode->height);
         }
 
+        current = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        if (current.refreshRate != mode->refreshRate)
+        {
+            printf("*** Refresh rate mismatch: %i Hz instead of %i Hz\n",
+                   current.refreshRate, mode->refreshRate);
+        }
+
         printf("Closing window\n");
 
         glfwDestroyWindow(window_handle);
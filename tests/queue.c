@@ -0,0 +1,139 @@
+//========================================================================
+// Event queue test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test enables the event queue and outputs every event it retrieves
+// from it, without setting any window or input callbacks
+//
+// The queue is kept small on purpose, so moving the mouse quickly while
+// the window is being dragged or resized should trigger an overflow error
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define QUEUE_SIZE 64
+
+static void error_callback(int error, const char* description)
+{
+    fprintf(stderr, "Error: %s\n", description);
+}
+
+static void print_event(unsigned int index, const GLFWevent* event)
+{
+    printf("%08x at %0.3f: ", index, event->time);
+
+    switch (event->type)
+    {
+        case GLFW_WINDOW_POS_EVENT:
+            printf("Window position: %i %i\n",
+                   event->data.pos.x, event->data.pos.y);
+            break;
+        case GLFW_WINDOW_SIZE_EVENT:
+            printf("Window size: %i %i\n",
+                   event->data.size.width, event->data.size.height);
+            break;
+        case GLFW_WINDOW_CLOSE_EVENT:
+            printf("Window close\n");
+            break;
+        case GLFW_WINDOW_REFRESH_EVENT:
+            printf("Window refresh\n");
+            break;
+        case GLFW_WINDOW_FOCUS_EVENT:
+            printf("Window %s\n",
+                   event->data.state ? "focused" : "defocused");
+            break;
+        case GLFW_WINDOW_ICONIFY_EVENT:
+            printf("Window was %s\n",
+                   event->data.state ? "iconified" : "restored");
+            break;
+        case GLFW_KEY_EVENT:
+            printf("Key 0x%04x was %s\n",
+                   event->data.key.key,
+                   event->data.key.action == GLFW_PRESS ? "pressed" : "released");
+            break;
+        case GLFW_CHAR_EVENT:
+            printf("Character 0x%08x input\n", event->data.character);
+            break;
+        case GLFW_MOUSE_BUTTON_EVENT:
+            printf("Mouse button %i was %s\n",
+                   event->data.button.button,
+                   event->data.button.action == GLFW_PRESS ? "pressed" : "released");
+            break;
+        case GLFW_CURSOR_POS_EVENT:
+            printf("Cursor position: %i %i\n",
+                   event->data.pos.x, event->data.pos.y);
+            break;
+        case GLFW_CURSOR_ENTER_EVENT:
+            printf("Cursor %s window\n",
+                   event->data.state ? "entered" : "left");
+            break;
+        case GLFW_SCROLL_EVENT:
+            printf("Scroll: %0.3f %0.3f\n",
+                   event->data.scroll.x, event->data.scroll.y);
+            break;
+        default:
+            printf("Unknown event 0x%08x\n", event->type);
+            break;
+    }
+}
+
+int main(void)
+{
+    unsigned int counter = 0;
+    GLFWwindow* window;
+
+    glfwSetErrorCallback(error_callback);
+
+    if (!glfwInit())
+        exit(EXIT_FAILURE);
+
+    glfwSetEventQueueSize(QUEUE_SIZE);
+
+    window = glfwCreateWindow(640, 480, "Event Queue", NULL, NULL);
+    if (!window)
+    {
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    while (!glfwGetWindowParam(window, GLFW_SHOULD_CLOSE))
+    {
+        int i, count;
+        GLFWevent events[QUEUE_SIZE];
+
+        glfwWaitEvents();
+
+        count = glfwGetEvents(events, QUEUE_SIZE);
+        for (i = 0;  i < count;  i++)
+            print_event(counter++, events + i);
+    }
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}
+
@@ -0,0 +1,172 @@
+//========================================================================
+// Input recording and replay test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test records the input of a window to a file, or replays a recording
+// to a window and reports how long it took to deliver
+//
+// Record a session with -r, then replay it with -p, optionally at a
+// different speed with -s (zero replays as fast as possible)
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "getopt.h"
+
+static unsigned int counter = 0;
+
+static void usage(void)
+{
+    printf("Usage: replay [-h] [-r FILE | -p FILE] [-s SPEED]\n");
+}
+
+static void error_callback(int error, const char* description)
+{
+    fprintf(stderr, "Error: %s\n", description);
+}
+
+static void key_callback(GLFWwindow* window, int key, int action)
+{
+    counter++;
+}
+
+static void char_callback(GLFWwindow* window, int character)
+{
+    counter++;
+}
+
+static void mouse_button_callback(GLFWwindow* window, int button, int action)
+{
+    counter++;
+}
+
+static void cursor_position_callback(GLFWwindow* window, int x, int y)
+{
+    counter++;
+}
+
+static void scroll_callback(GLFWwindow* window, double x, double y)
+{
+    counter++;
+}
+
+int main(int argc, char** argv)
+{
+    int ch;
+    double speed = 1.0, start;
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    GLFWwindow* window;
+
+    while ((ch = getopt(argc, argv, "hp:r:s:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+
+            case 'p':
+                replayPath = optarg;
+                break;
+
+            case 'r':
+                recordPath = optarg;
+                break;
+
+            case 's':
+                speed = atof(optarg);
+                break;
+
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!recordPath == !replayPath)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    glfwSetErrorCallback(error_callback);
+
+    if (!glfwInit())
+        exit(EXIT_FAILURE);
+
+    window = glfwCreateWindow(640, 480, "Input Replay", NULL, NULL);
+    if (!window)
+    {
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetCharCallback(window, char_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetCursorPosCallback(window, cursor_position_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    if (recordPath)
+    {
+        if (!glfwRecordInput(window, recordPath))
+        {
+            glfwTerminate();
+            exit(EXIT_FAILURE);
+        }
+
+        printf("Recording to %s, close the window to stop\n", recordPath);
+
+        while (!glfwGetWindowParam(window, GLFW_SHOULD_CLOSE))
+            glfwWaitEvents();
+
+        glfwRecordInput(window, NULL);
+        printf("Recorded %u input events\n", counter);
+    }
+    else
+    {
+        if (!glfwReplayInput(window, replayPath, speed))
+        {
+            glfwTerminate();
+            exit(EXIT_FAILURE);
+        }
+
+        start = glfwGetTime();
+
+        while (glfwGetWindowParam(window, GLFW_REPLAYING))
+            glfwWaitEvents();
+
+        printf("Replayed %u input events in %0.3f seconds\n",
+               counter, glfwGetTime() - start);
+    }
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}
+
@@ -0,0 +1,199 @@
+//========================================================================
+// Input replay re-entrancy test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test writes a recording of key presses and replays it as fast as
+// possible, first stopping the replay from the key callback and then
+// destroying the replaying window from it, while another window replays
+// the same recording
+//
+// It checks that no records are delivered after the replay was stopped or
+// the window destroyed, and that the other window receives all of them
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define RECORD_COUNT 8
+#define STOP_COUNT 3
+
+#define RECORDING_PATH "replaystop.rec"
+
+// A record of an input recording, as written by glfwRecordInput
+typedef struct
+{
+    int type;
+    int reserved;
+    double time;
+    double x, y;
+} Record;
+
+typedef enum
+{
+    STOP_REPLAY,
+    DESTROY_WINDOW
+} Action;
+
+static Action action;
+static GLFWwindow* target;
+static unsigned int targetCount = 0;
+static unsigned int otherCount = 0;
+
+static void error_callback(int error, const char* description)
+{
+    fprintf(stderr, "Error: %s\n", description);
+}
+
+static void key_callback(GLFWwindow* window, int key, int state)
+{
+    if (window != target)
+    {
+        otherCount++;
+        return;
+    }
+
+    if (++targetCount < STOP_COUNT)
+        return;
+
+    if (action == STOP_REPLAY)
+        glfwReplayInput(window, NULL, 0.0);
+    else
+    {
+        glfwDestroyWindow(window);
+        target = NULL;
+    }
+}
+
+static int write_recording(const char* path)
+{
+    int i;
+    FILE* file;
+
+    file = fopen(path, "wb");
+    if (!file)
+        return GL_FALSE;
+
+    fwrite("GLFWREC\001", 8, 1, file);
+
+    for (i = 0;  i < RECORD_COUNT;  i++)
+    {
+        Record record;
+
+        record.type = GLFW_KEY_EVENT;
+        record.reserved = 0;
+        record.time = 0.0;
+        record.x = GLFW_KEY_A + i;
+        record.y = GLFW_PRESS;
+
+        fwrite(&record, sizeof(record), 1, file);
+    }
+
+    return fclose(file) == 0;
+}
+
+static GLFWwindow* create_window(void)
+{
+    GLFWwindow* window = glfwCreateWindow(200, 200, "Replay Stop", NULL, NULL);
+    if (!window)
+    {
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    glfwSetKeyCallback(window, key_callback);
+    return window;
+}
+
+static int run(Action selected, const char* path)
+{
+    GLFWwindow* other;
+
+    action = selected;
+    target = create_window();
+    other = create_window();
+    targetCount = otherCount = 0;
+
+    if (!glfwReplayInput(target, path, 0.0) ||
+        !glfwReplayInput(other, path, 0.0))
+    {
+        return GL_FALSE;
+    }
+
+    glfwPollEvents();
+
+    if (target)
+    {
+        if (glfwGetWindowParam(target, GLFW_REPLAYING))
+        {
+            fprintf(stderr, "Replay was not stopped\n");
+            return GL_FALSE;
+        }
+
+        // Polling again must not resume the stopped replay
+        glfwPollEvents();
+        glfwDestroyWindow(target);
+    }
+
+    glfwDestroyWindow(other);
+
+    printf("%s: %u of %u records delivered, %u to the other window\n",
+           action == STOP_REPLAY ? "Stop replay" : "Destroy window",
+           targetCount, RECORD_COUNT, otherCount);
+
+    return targetCount == STOP_COUNT && otherCount == RECORD_COUNT;
+}
+
+int main(void)
+{
+    int result = EXIT_SUCCESS;
+
+    glfwSetErrorCallback(error_callback);
+
+    if (!write_recording(RECORDING_PATH))
+    {
+        fprintf(stderr, "Failed to write recording\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!glfwInit())
+    {
+        remove(RECORDING_PATH);
+        exit(EXIT_FAILURE);
+    }
+
+    if (!run(STOP_REPLAY, RECORDING_PATH) ||
+        !run(DESTROY_WINDOW, RECORDING_PATH))
+    {
+        result = EXIT_FAILURE;
+    }
+
+    glfwTerminate();
+    remove(RECORDING_PATH);
+
+    exit(result);
+}
+
@@ -0,0 +1,160 @@
+//========================================================================
+// Keysym to Unicode conversion test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test checks that the table based keysym to Unicode conversion of the
+// X11 backend agrees with a binary search of the original mapping table for
+// every keysym up to and including the directly encoded UCS range, and then
+// compares the speed of the two
+//
+// The search uses a sorted copy of the mapping table, as the keypad entries
+// at its end are not in order, which made the original binary search miss
+// some of them
+//
+// It includes the conversion source file directly in order to reach the
+// mapping table, so it needs no X server
+//
+//========================================================================
+
+#include "x11_unicode.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCHMARK_ROUNDS 20000
+#define CODEPAIR_COUNT (sizeof(keysymtab) / sizeof(struct codepair))
+
+static struct codepair sorted[CODEPAIR_COUNT];
+
+static int compare_codepairs(const void* first, const void* second)
+{
+    const struct codepair* fp = first;
+    const struct codepair* sp = second;
+
+    return (int) fp->keysym - (int) sp->keysym;
+}
+
+// This is the original binary search implementation of the conversion
+static long search_keysym(KeySym keysym)
+{
+    int min = 0;
+    int max = CODEPAIR_COUNT - 1;
+    int mid;
+
+    if ((keysym >= 0x0020 && keysym <= 0x007e) ||
+        (keysym >= 0x00a0 && keysym <= 0x00ff))
+    {
+        return keysym;
+    }
+
+    if ((keysym & 0xff000000) == 0x01000000)
+        return keysym & 0x00ffffff;
+
+    while (max >= min)
+    {
+        mid = (min + max) / 2;
+        if (sorted[mid].keysym < keysym)
+            min = mid + 1;
+        else if (sorted[mid].keysym > keysym)
+            max = mid - 1;
+        else
+            return sorted[mid].ucs;
+    }
+
+    return -1;
+}
+
+static double benchmark(long (*convert)(KeySym), const KeySym* keysyms, int count)
+{
+    int i, j;
+    long sum = 0;
+    clock_t start = clock();
+
+    for (i = 0;  i < BENCHMARK_ROUNDS;  i++)
+    {
+        for (j = 0;  j < count;  j++)
+            sum += convert(keysyms[j]);
+    }
+
+    // Use the result so the loop is not optimized away
+    if (sum == 0)
+        printf("Unexpected checksum\n");
+
+    return (double) (clock() - start) / CLOCKS_PER_SEC * 1e9 /
+           ((double) BENCHMARK_ROUNDS * count);
+}
+
+int main(void)
+{
+    KeySym keysym;
+    unsigned long errors = 0;
+    int i, count = 0;
+    KeySym keysyms[CODEPAIR_COUNT + 0x100];
+
+    _glfwInitKeySymTable();
+
+    memcpy(sorted, keysymtab, sizeof(sorted));
+    qsort(sorted, CODEPAIR_COUNT, sizeof(struct codepair), compare_codepairs);
+
+    for (keysym = 0;  keysym <= 0x01ffffff;  keysym++)
+    {
+        const long expected = search_keysym(keysym);
+        const long result = _glfwKeySym2Unicode(keysym);
+
+        if (result != expected)
+        {
+            if (errors < 10)
+            {
+                printf("Keysym 0x%08lx maps to %li instead of %li\n",
+                       (unsigned long) keysym, result, expected);
+            }
+
+            errors++;
+        }
+    }
+
+    if (errors)
+    {
+        printf("%lu keysyms were converted incorrectly\n", errors);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("All keysyms up to 0x01ffffff were converted correctly\n");
+
+    // Benchmark with a mix of Latin-1 and table keysyms, as typed text has
+    for (i = 0x20;  i <= 0x7e;  i++)
+        keysyms[count++] = i;
+
+    for (i = 0;  i < CODEPAIR_COUNT;  i++)
+        keysyms[count++] = keysymtab[i].keysym;
+
+    printf("%10s %14s\n", "method", "ns/keysym");
+    printf("%10s %14.2f\n", "search", benchmark(search_keysym, keysyms, count));
+    printf("%10s %14.2f\n", "table", benchmark(_glfwKeySym2Unicode, keysyms, count));
+
+    exit(EXIT_SUCCESS);
+}
+